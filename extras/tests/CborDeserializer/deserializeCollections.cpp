@@ -0,0 +1,143 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#define CBOR(s) std::string(s, sizeof(s) - 1)
+
+static void check(const std::string& input, const std::string& expected) {
+  DynamicJsonDocument doc(4096);
+
+  DeserializationError error = deserializeCbor(doc, input);
+
+  REQUIRE(error == DeserializationError::Ok);
+  REQUIRE(doc.as<std::string>() == expected);
+}
+
+TEST_CASE("deserialize CBOR array") {
+  SECTION("definite length") {
+    check("\x80", "[]");
+    check(CBOR("\x83\x01\x02\x03"), "[1,2,3]");
+    check("\x83\x01\x82\x02\x03\x82\x04\x05", "[1,[2,3],[4,5]]");
+  }
+
+  SECTION("25 elements") {
+    std::string input = "\x98\x19";
+    for (int i = 1; i <= 25; i++)
+      input += i < 24 ? std::string(1, char(i))
+                      : "\x18" + std::string(1, char(i));
+
+    check(input,
+          "[1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,21,22,23,24,"
+          "25]");
+  }
+
+  SECTION("indefinite length") {
+    check("\x9F\xFF", "[]");
+    check("\x9F\x01\x82\x02\x03\x9F\x04\x05\xFF\xFF", "[1,[2,3],[4,5]]");
+    check("\x9F\x01\x82\x02\x03\x82\x04\x05\xFF", "[1,[2,3],[4,5]]");
+    check("\x83\x01\x82\x02\x03\x9F\x04\x05\xFF", "[1,[2,3],[4,5]]");
+    check("\x83\x01\x9F\x02\x03\xFF\x82\x04\x05", "[1,[2,3],[4,5]]");
+  }
+
+  SECTION("definite length allocates the elements at once") {
+    StaticJsonDocument<JSON_ARRAY_SIZE(2)> doc;
+
+    DeserializationError error = deserializeCbor(doc, "\x83\x61\x61");
+
+    REQUIRE(error == DeserializationError::NoMemory);
+    REQUIRE(doc.memoryUsage() == 0);
+  }
+
+  SECTION("indefinite length NoMemory") {
+    StaticJsonDocument<JSON_ARRAY_SIZE(2)> doc;
+
+    DeserializationError error =
+        deserializeCbor(doc, CBOR("\x9F\x01\x02\x03\xFF"));
+
+    REQUIRE(error == DeserializationError::NoMemory);
+  }
+}
+
+TEST_CASE("deserialize CBOR map") {
+  SECTION("definite length") {
+    check("\xA0", "{}");
+    check("\xA2\x61\x61\x01\x61\x62\x82\x02\x03", "{\"a\":1,\"b\":[2,3]}");
+    check("\x82\x61\x61\xA1\x61\x62\x61\x63", "[\"a\",{\"b\":\"c\"}]");
+  }
+
+  SECTION("indefinite length") {
+    check("\xBF\xFF", "{}");
+    check("\xBF\x61\x61\x01\x61\x62\x9F\x02\x03\xFF\xFF",
+          "{\"a\":1,\"b\":[2,3]}");
+    check("\x82\x61\x61\xBF\x61\x62\x61\x63\xFF", "[\"a\",{\"b\":\"c\"}]");
+    check("\xBF\x63\x46un\xF5\x63\x41mt\x21\xFF",
+          "{\"Fun\":true,\"Amt\":-2}");
+  }
+
+  SECTION("indefinite length key") {
+    check("\xA1\x7F\x62he\x63llo\xFF\xF5", "{\"hello\":true}");
+  }
+}
+
+TEST_CASE("deserializeCbor() with Filter") {
+  DynamicJsonDocument doc(4096);
+  StaticJsonDocument<200> filter;
+  filter["a"] = true;
+
+  SECTION("definite length") {
+    DeserializationError error = deserializeCbor(
+        doc,
+        CBOR("\xA3\x61\x62\x83\x01\x5F\x41\x00\xFF\xF9\x3C\x00\x61\x61\x01"
+             "\x61\x63\xC1\x7F\x61x\xFF"),
+        DeserializationOption::Filter(filter));
+
+    REQUIRE(error == DeserializationError::Ok);
+    REQUIRE(doc.as<std::string>() == "{\"a\":1}");
+  }
+
+  SECTION("indefinite length") {
+    DeserializationError error = deserializeCbor(
+        doc, "\xBF\x61\x62\xBF\x61x\x9F\xFF\xFF\x61\x61\x18\x2A\xFF",
+        DeserializationOption::Filter(filter));
+
+    REQUIRE(error == DeserializationError::Ok);
+    REQUIRE(doc.as<std::string>() == "{\"a\":42}");
+  }
+
+  SECTION("array elements") {
+    StaticJsonDocument<200> elementFilter;
+    elementFilter[0]["a"] = true;
+
+    DeserializationError error = deserializeCbor(
+        doc, "\x9F\xA2\x61\x61\x01\x61\x62\x02\xA1\x61\x61\x03\xFF",
+        DeserializationOption::Filter(elementFilter));
+
+    REQUIRE(error == DeserializationError::Ok);
+    REQUIRE(doc.as<std::string>() == "[{\"a\":1},{\"a\":3}]");
+  }
+}
+
+TEST_CASE("deserializeCbor() with NestingLimit") {
+  DynamicJsonDocument doc(4096);
+
+  SECTION("definite length") {
+    REQUIRE(deserializeCbor(doc, "\x81\x81\x01",
+                            DeserializationOption::NestingLimit(1)) ==
+            DeserializationError::TooDeep);
+    REQUIRE(deserializeCbor(doc, "\x81\x81\x01",
+                            DeserializationOption::NestingLimit(2)) ==
+            DeserializationError::Ok);
+  }
+
+  SECTION("indefinite length") {
+    REQUIRE(deserializeCbor(doc, "\x9F\xBF\xFF\xFF",
+                            DeserializationOption::NestingLimit(1)) ==
+            DeserializationError::TooDeep);
+    REQUIRE(deserializeCbor(doc, "\x9F\xBF\xFF\xFF",
+                            DeserializationOption::NestingLimit(2)) ==
+            DeserializationError::Ok);
+  }
+}
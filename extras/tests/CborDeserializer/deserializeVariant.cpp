@@ -0,0 +1,187 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <limits>
+
+#define CBOR(s) std::string(s, sizeof(s) - 1)
+
+template <typename T, typename U>
+static void check(const std::string& input, U expected) {
+  DynamicJsonDocument doc(4096);
+
+  DeserializationError error = deserializeCbor(doc, input);
+
+  REQUIRE(error == DeserializationError::Ok);
+  REQUIRE(doc.is<T>());
+  REQUIRE(doc.as<T>() == expected);
+}
+
+TEST_CASE("deserialize CBOR value") {
+  SECTION("null") {
+    DynamicJsonDocument doc(4096);
+
+    REQUIRE(deserializeCbor(doc, "\xF6") == DeserializationError::Ok);
+    REQUIRE(doc.isNull());
+  }
+
+  SECTION("undefined becomes null") {
+    DynamicJsonDocument doc(4096);
+
+    REQUIRE(deserializeCbor(doc, "\xF7") == DeserializationError::Ok);
+    REQUIRE(doc.isNull());
+  }
+
+  SECTION("bool") {
+    check<bool>("\xF4", false);
+    check<bool>("\xF5", true);
+  }
+
+  SECTION("unsigned integers") {
+    check<int>(CBOR("\x00"), 0);
+    check<int>("\x01", 1);
+    check<int>("\x17", 23);
+    check<int>("\x18\x18", 24);
+    check<int>("\x18\x64", 100);
+    check<int>("\x19\x03\xE8", 1000);
+    check<long>(CBOR("\x1A\x00\x0F\x42\x40"), 1000000L);
+    check<unsigned long>("\x1A\xFF\xFF\xFF\xFF", 0xFFFFFFFFUL);
+  }
+
+#if ARDUINOJSON_USE_LONG_LONG
+  SECTION("unsigned 64-bit integers") {
+    check<unsigned long long>(CBOR("\x1B\x00\x00\x00\xE8\xD4\xA5\x10\x00"),
+                              1000000000000ULL);
+    check<unsigned long long>("\x1B\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF",
+                              0xFFFFFFFFFFFFFFFFULL);
+  }
+#endif
+
+  SECTION("negative integers") {
+    check<int>("\x20", -1);
+    check<int>("\x29", -10);
+    check<int>("\x38\x63", -100);
+    check<int>("\x39\x03\xE7", -1000);
+    check<long>(CBOR("\x3A\x00\x01\x00\x00"), -65537L);
+  }
+
+#if ARDUINOJSON_USE_LONG_LONG
+  SECTION("negative 64-bit integers") {
+    check<long long>("\x3B\x7F\xFF\xFF\xFF\xFF\xFF\xFF\xFF",
+                     -9223372036854775807LL - 1);
+  }
+#endif
+
+  SECTION("half-precision floats") {
+    check<double>(CBOR("\xF9\x00\x00"), 0.0);
+    check<double>(CBOR("\xF9\x3C\x00"), 1.0);
+    check<double>(CBOR("\xF9\x3E\x00"), 1.5);
+    check<double>("\xF9\x7B\xFF", 65504.0);
+    check<double>(CBOR("\xF9\xC4\x00"), -4.0);
+    check<double>(CBOR("\xF9\x04\x00"), 0.00006103515625);
+    check<double>(CBOR("\xF9\x00\x01"), 5.960464477539063e-8);
+    check<double>(CBOR("\xF9\x7C\x00"),
+                  std::numeric_limits<double>::infinity());
+    check<double>(CBOR("\xF9\xFC\x00"),
+                  -std::numeric_limits<double>::infinity());
+  }
+
+  SECTION("half-precision NaN") {
+    DynamicJsonDocument doc(4096);
+
+    REQUIRE(deserializeCbor(doc, CBOR("\xF9\x7E\x00")) ==
+            DeserializationError::Ok);
+    REQUIRE(doc.as<double>() != doc.as<double>());
+  }
+
+  SECTION("half-precision negative zero") {
+    DynamicJsonDocument doc(4096);
+
+    deserializeCbor(doc, CBOR("\xF9\x80\x00"));
+
+    REQUIRE(doc.as<double>() == 0.0);
+    REQUIRE(1 / doc.as<double>() < 0);
+  }
+
+  SECTION("single-precision floats") {
+    check<double>(CBOR("\xFA\x47\xC3\x50\x00"), 100000.0);
+    check<double>("\xFA\x7F\x7F\xFF\xFF", 3.4028234663852886e+38);
+  }
+
+  SECTION("double-precision floats") {
+    check<double>("\xFB\x3F\xF1\x99\x99\x99\x99\x99\x9A", 1.1);
+    check<double>(CBOR("\xFB\x7E\x37\xE4\x3C\x88\x00\x75\x9C"), 1.0e+300);
+    check<double>("\xFB\xC0\x10\x66\x66\x66\x66\x66\x66", -4.1);
+  }
+
+  SECTION("text strings") {
+    check<std::string>("\x60", std::string());
+    check<std::string>("\x61\x61", std::string("a"));
+    check<std::string>("\x64IETF", std::string("IETF"));
+    check<std::string>("\x62\xC3\xBC", std::string("\xC3\xBC"));
+    check<std::string>("\x78\x18" + std::string(24, '?'),
+                       std::string(24, '?'));
+  }
+
+  SECTION("indefinite length text string") {
+    check<std::string>("\x7F\x65strea\x64ming\xFF", std::string("streaming"));
+    check<std::string>("\x7F\xFF", std::string());
+  }
+
+  SECTION("tags are ignored") {
+    check<std::string>("\xC0\x74" "2013-03-21T20:04:00Z",
+                       std::string("2013-03-21T20:04:00Z"));
+    check<long>("\xC1\x1A\x51\x4B\x67\xB0", 1363896240L);
+    check<double>(CBOR("\xC1\xFB\x41\xD4\x52\xD9\xEC\x20\x00\x00"),
+                  1363896240.5);
+    check<std::string>("\xD8\x20\x76http://www.example.com",
+                       std::string("http://www.example.com"));
+  }
+}
+
+static std::string bytes(const MsgPackBinary& bin) {
+  return std::string(reinterpret_cast<const char*>(bin.data()), bin.size());
+}
+
+TEST_CASE("deserialize CBOR byte string") {
+  DynamicJsonDocument doc(4096);
+
+  SECTION("empty") {
+    DeserializationError error = deserializeCbor(doc, "\x40");
+
+    REQUIRE(error == DeserializationError::Ok);
+    REQUIRE(doc.is<MsgPackBinary>());
+    REQUIRE(doc.as<MsgPackBinary>().size() == 0);
+  }
+
+  SECTION("definite length") {
+    DeserializationError error =
+        deserializeCbor(doc, CBOR("\x44\x01\x00\x03\x04"));
+
+    REQUIRE(error == DeserializationError::Ok);
+    REQUIRE(bytes(doc.as<MsgPackBinary>()) == CBOR("\x01\x00\x03\x04"));
+    REQUIRE(doc.memoryUsage() == 5);
+  }
+
+  SECTION("indefinite length") {
+    DeserializationError error =
+        deserializeCbor(doc, CBOR("\x5F\x42\x01\x02\x43\x03\x00\x05\xFF"));
+
+    REQUIRE(error == DeserializationError::Ok);
+    REQUIRE(bytes(doc.as<MsgPackBinary>()) == CBOR("\x01\x02\x03\x00\x05"));
+  }
+
+  SECTION("in a writable input") {
+    char input[] = "\x82\x42\x01\x02\x5F\x41\x03\x41\x04\xFF";
+
+    DeserializationError error = deserializeCbor(doc, input);
+
+    REQUIRE(error == DeserializationError::Ok);
+    REQUIRE(doc.memoryUsage() == JSON_ARRAY_SIZE(2));
+    REQUIRE(bytes(doc[0].as<MsgPackBinary>()) == "\x01\x02");
+    REQUIRE(bytes(doc[1].as<MsgPackBinary>()) == "\x03\x04");
+  }
+}
@@ -0,0 +1,132 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#define CBOR(s) std::string(s, sizeof(s) - 1)
+
+static void check(const std::string& input, DeserializationError expected) {
+  DynamicJsonDocument doc(4096);
+
+  DeserializationError error = deserializeCbor(doc, input);
+
+  CAPTURE(input);
+  REQUIRE(error == expected);
+}
+
+TEST_CASE("deserializeCbor() returns IncompleteInput") {
+  SECTION("empty input") {
+    check("", DeserializationError::IncompleteInput);
+  }
+
+  SECTION("argument") {
+    check("\x18", DeserializationError::IncompleteInput);
+    check("\x19\x01", DeserializationError::IncompleteInput);
+    check(CBOR("\x1A\x00\x01"), DeserializationError::IncompleteInput);
+    check(CBOR("\x3A\x00\x00"), DeserializationError::IncompleteInput);
+  }
+
+  SECTION("floats") {
+    check("\xF9\x3C", DeserializationError::IncompleteInput);
+    check("\xFA\x47\xC3", DeserializationError::IncompleteInput);
+    check("\xFB\x3F\xF1\x99", DeserializationError::IncompleteInput);
+  }
+
+  SECTION("strings") {
+    check("\x62\x61", DeserializationError::IncompleteInput);
+    check("\x43\x01\x02", DeserializationError::IncompleteInput);
+    check("\x7F\x61\x61", DeserializationError::IncompleteInput);
+    check("\x5F\x42\x01", DeserializationError::IncompleteInput);
+  }
+
+  SECTION("collections") {
+    check("\x82\x01", DeserializationError::IncompleteInput);
+    check("\x9F\x01\x02", DeserializationError::IncompleteInput);
+    check("\xA1\x61\x61", DeserializationError::IncompleteInput);
+    check("\xBF\x61\x61\x01", DeserializationError::IncompleteInput);
+  }
+
+  SECTION("tag") {
+    check("\xC1", DeserializationError::IncompleteInput);
+  }
+}
+
+TEST_CASE("deserializeCbor() returns InvalidInput") {
+  SECTION("reserved additional information") {
+    check("\x1C", DeserializationError::InvalidInput);
+    check("\x5D", DeserializationError::InvalidInput);
+    check("\xFC", DeserializationError::InvalidInput);
+  }
+
+  SECTION("indefinite length integer") {
+    check("\x1F", DeserializationError::InvalidInput);
+    check("\x3F", DeserializationError::InvalidInput);
+  }
+
+  SECTION("break outside of an indefinite length item") {
+    check("\xFF", DeserializationError::InvalidInput);
+    check("\x81\xFF", DeserializationError::InvalidInput);
+  }
+
+  SECTION("chunk of a different type") {
+    check("\x7F\x41\x61\xFF", DeserializationError::InvalidInput);
+    check("\x5F\x61\x61\xFF", DeserializationError::InvalidInput);
+  }
+}
+
+TEST_CASE("deserializeCbor() returns NotSupported") {
+  SECTION("simple values") {
+    check("\xF0", DeserializationError::NotSupported);
+    check("\xF8\xFF", DeserializationError::NotSupported);
+  }
+
+  SECTION("keys other than text strings") {
+    check(CBOR("\xA1\x01\x02"), DeserializationError::NotSupported);
+    check("\xA1\x41\x61\x02", DeserializationError::NotSupported);
+  }
+
+#if ARDUINOJSON_USE_LONG_LONG
+  SECTION("negative integer below the range of Integer") {
+    check("\x3B\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF",
+          DeserializationError::NotSupported);
+  }
+#endif
+}
+
+TEST_CASE("deserializeCbor() returns NoMemory") {
+  StaticJsonDocument<JSON_ARRAY_SIZE(1)> doc;
+
+  SECTION("string") {
+    REQUIRE(deserializeCbor(doc, "\x81\x69too long!") ==
+            DeserializationError::NoMemory);
+  }
+
+  SECTION("indefinite length string") {
+    REQUIRE(deserializeCbor(doc, "\x81\x7F\x65hello\x64 you\xFF") ==
+            DeserializationError::NoMemory);
+  }
+
+  SECTION("array") {
+    REQUIRE(deserializeCbor(doc, "\x82\xF5\xF5") ==
+            DeserializationError::NoMemory);
+  }
+
+  SECTION("string with a length that wraps around") {
+    StaticJsonDocument<64> small;
+
+    REQUIRE(deserializeCbor(small, "\x7A\xFF\xFF\xFF\xFF" +
+                                       std::string(4096, '?')) ==
+            DeserializationError::NoMemory);
+    REQUIRE(deserializeCbor(small, "\x5A\xFF\xFF\xFF\xFF" +
+                                       std::string(4096, '?')) ==
+            DeserializationError::NoMemory);
+#if ARDUINOJSON_USE_LONG_LONG
+    REQUIRE(deserializeCbor(small,
+                            "\x7B\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF" +
+                                std::string(4096, '?')) ==
+            DeserializationError::NoMemory);
+#endif
+  }
+}
@@ -0,0 +1,103 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#define CBOR(s) std::string(s, sizeof(s) - 1)
+
+static void check(const JsonDocument& doc, const std::string& expected) {
+  std::string actual;
+  size_t len = serializeCbor(doc, actual);
+  REQUIRE(len == expected.size());
+  REQUIRE(actual == expected);
+  REQUIRE(measureCbor(doc) == expected.size());
+}
+
+TEST_CASE("serialize CBOR array") {
+  DynamicJsonDocument doc(4096);
+  JsonArray array = doc.to<JsonArray>();
+
+  SECTION("empty") {
+    check(doc, "\x80");
+  }
+
+  SECTION("[1,[2,3],[4,5]]") {
+    array.add(1);
+    JsonArray a = array.createNestedArray();
+    a.add(2);
+    a.add(3);
+    JsonArray b = array.createNestedArray();
+    b.add(4);
+    b.add(5);
+
+    check(doc, "\x83\x01\x82\x02\x03\x82\x04\x05");
+  }
+
+  SECTION("25 elements") {
+    std::string expected = "\x98\x19";
+    for (int i = 1; i <= 25; i++) {
+      array.add(i);
+      expected += i < 24 ? std::string(1, char(i))
+                         : "\x18" + std::string(1, char(i));
+    }
+
+    check(doc, expected);
+  }
+}
+
+TEST_CASE("serialize CBOR object") {
+  DynamicJsonDocument doc(4096);
+  JsonObject object = doc.to<JsonObject>();
+
+  SECTION("empty") {
+    check(doc, "\xA0");
+  }
+
+  SECTION("{\"a\":1,\"b\":[2,3]}") {
+    object["a"] = 1;
+    JsonArray b = object.createNestedArray("b");
+    b.add(2);
+    b.add(3);
+
+    check(doc, "\xA2\x61\x61\x01\x61\x62\x82\x02\x03");
+  }
+
+  SECTION("nested in an array") {
+    JsonArray array = doc.to<JsonArray>();
+    array.add("a");
+    array.createNestedObject()["b"] = "c";
+
+    check(doc, "\x82\x61\x61\xA1\x61\x62\x61\x63");
+  }
+}
+
+TEST_CASE("serializeCbor() to a buffer") {
+  StaticJsonDocument<JSON_ARRAY_SIZE(1)> doc;
+  doc.add(true);
+  char buffer[8];
+
+  REQUIRE(serializeCbor(doc, buffer, sizeof(buffer)) == 2);
+  REQUIRE(std::string(buffer, 2) == "\x81\xF5");
+}
+
+TEST_CASE("measureCbor()") {
+  DynamicJsonDocument doc(4096);
+  doc["hello"] = "world";
+
+  REQUIRE(measureCbor(doc) == 13);
+}
+
+TEST_CASE("CBOR round trip") {
+  DynamicJsonDocument doc(4096);
+  std::string input = CBOR(
+      "\xA4\x61\x61\xF9\x3E\x00\x61\x62\x83\x01\x20\xF5\x61\x63\xF6\x61\x64"
+      "\x42\x00\x01");
+
+  REQUIRE(deserializeCbor(doc, input) == DeserializationError::Ok);
+  std::string output;
+  serializeCbor(doc, output);
+
+  REQUIRE(output == input);
+}
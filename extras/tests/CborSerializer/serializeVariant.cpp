@@ -0,0 +1,127 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <limits>
+
+#define CBOR(s) std::string(s, sizeof(s) - 1)
+
+template <typename T>
+static void checkVariant(T value, const std::string& expected) {
+  DynamicJsonDocument doc(4096);
+  JsonVariant variant = doc.to<JsonVariant>();
+  variant.set(value);
+  std::string actual;
+  size_t len = serializeCbor(variant, actual);
+  CAPTURE(variant);
+  REQUIRE(len == expected.size());
+  REQUIRE(actual == expected);
+}
+
+TEST_CASE("serialize CBOR value") {
+  SECTION("undefined") {
+    checkVariant(JsonVariant(), "\xF6");  // we represent undefined as null
+  }
+
+  SECTION("null") {
+    const char* nil = 0;  // ArduinoJson uses a string for null
+    checkVariant(nil, "\xF6");
+  }
+
+  SECTION("bool") {
+    checkVariant(false, "\xF4");
+    checkVariant(true, "\xF5");
+  }
+
+  SECTION("unsigned integers") {
+    checkVariant(0, CBOR("\x00"));
+    checkVariant(23, "\x17");
+    checkVariant(24, "\x18\x18");
+    checkVariant(255, "\x18\xFF");
+    checkVariant(256, CBOR("\x19\x01\x00"));
+    checkVariant(65535, "\x19\xFF\xFF");
+    checkVariant(65536, CBOR("\x1A\x00\x01\x00\x00"));
+    checkVariant(1000000, CBOR("\x1A\x00\x0F\x42\x40"));
+  }
+
+#if ARDUINOJSON_USE_LONG_LONG
+  SECTION("unsigned 64-bit integers") {
+    checkVariant(1000000000000ULL,
+                 CBOR("\x1B\x00\x00\x00\xE8\xD4\xA5\x10\x00"));
+    checkVariant(0xFFFFFFFFFFFFFFFFULL, "\x1B\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF");
+  }
+#endif
+
+  SECTION("negative integers") {
+    checkVariant(-1, "\x20");
+    checkVariant(-10, "\x29");
+    checkVariant(-24, "\x37");
+    checkVariant(-25, "\x38\x18");
+    checkVariant(-100, "\x38\x63");
+    checkVariant(-1000, "\x39\x03\xE7");
+    checkVariant(-65537, CBOR("\x3A\x00\x01\x00\x00"));
+  }
+
+#if ARDUINOJSON_USE_LONG_LONG
+  SECTION("negative 64-bit integers") {
+    checkVariant(-9223372036854775807LL - 1,
+                 "\x3B\x7F\xFF\xFF\xFF\xFF\xFF\xFF\xFF");
+  }
+#endif
+
+  SECTION("half-precision floats") {
+    checkVariant(0.0, CBOR("\xF9\x00\x00"));
+    checkVariant(-0.0, CBOR("\xF9\x80\x00"));
+    checkVariant(1.0, CBOR("\xF9\x3C\x00"));
+    checkVariant(1.5, CBOR("\xF9\x3E\x00"));
+    checkVariant(65504.0, "\xF9\x7B\xFF");
+    checkVariant(-4.0, CBOR("\xF9\xC4\x00"));
+    checkVariant(0.00006103515625, CBOR("\xF9\x04\x00"));  // smallest normal
+    checkVariant(5.960464477539063e-8, CBOR("\xF9\x00\x01"));  // subnormal
+    checkVariant(std::numeric_limits<double>::infinity(), CBOR("\xF9\x7C\x00"));
+    checkVariant(-std::numeric_limits<double>::infinity(),
+                 CBOR("\xF9\xFC\x00"));
+    checkVariant(std::numeric_limits<double>::quiet_NaN(),
+                 CBOR("\xF9\x7E\x00"));
+  }
+
+  SECTION("single-precision floats") {
+    checkVariant(100000.0, CBOR("\xFA\x47\xC3\x50\x00"));
+    checkVariant(3.4028234663852886e+38, "\xFA\x7F\x7F\xFF\xFF");
+    checkVariant(1.25f + 1.0f / 4096, CBOR("\xFA\x3F\xA0\x08\x00"));
+  }
+
+  SECTION("double-precision floats") {
+    checkVariant(1.1, "\xFB\x3F\xF1\x99\x99\x99\x99\x99\x9A");
+    checkVariant(-4.1, "\xFB\xC0\x10\x66\x66\x66\x66\x66\x66");
+    checkVariant(1.0e+300, CBOR("\xFB\x7E\x37\xE4\x3C\x88\x00\x75\x9C"));
+  }
+
+  SECTION("text strings") {
+    checkVariant("", "\x60");
+    checkVariant("a", "\x61\x61");
+    checkVariant("IETF", "\x64IETF");
+    checkVariant("\xC3\xBC", "\x62\xC3\xBC");
+    checkVariant(std::string(24, '?'), "\x78\x18" + std::string(24, '?'));
+    checkVariant(std::string(256, '?'),
+                 CBOR("\x79\x01\x00") + std::string(256, '?'));
+  }
+
+  SECTION("serialized(const char*)") {
+    checkVariant(serialized("\xF5"), "\xF5");
+  }
+
+  SECTION("MsgPackBinary") {
+    const uint8_t data[] = {1, 2, 3, 4};
+    checkVariant(MsgPackBinary(data, 0), "\x40");
+    checkVariant(MsgPackBinary(data, 4), "\x44\x01\x02\x03\x04");
+  }
+
+  SECTION("MsgPackExtension is written as null") {
+    const uint8_t data[] = {1};
+    checkVariant(MsgPackExtension(1, data, 1), "\xF6");
+  }
+}
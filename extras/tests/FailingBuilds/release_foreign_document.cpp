@@ -0,0 +1,13 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#define ARDUINOJSON_ENABLE_STD_MUTEX 1
+#include <ArduinoJson.h>
+
+// JsonDocumentPool::release() only takes the documents of acquire()
+int main() {
+  JsonDocumentPool pool(256);
+  DynamicJsonDocument doc(256);
+  pool.release(&doc);
+}
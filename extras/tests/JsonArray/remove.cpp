@@ -65,4 +65,30 @@ TEST_CASE("JsonArray::remove()") {
     REQUIRE(_array[0] == 1);
     REQUIRE(_array[1] == 2);
   }
+
+  SECTION("Remove while iterating") {
+    _array.add(4);
+    _array.add(5);
+
+    SECTION("all") {
+      for (JsonArray::iterator it = _array.begin(); it != _array.end(); ++it)
+        _array.remove(it);
+
+      REQUIRE(0 == _array.size());
+    }
+
+    SECTION("consecutive elements after the first") {
+      for (JsonArray::iterator it = _array.begin(); it != _array.end(); ++it) {
+        if (*it == 2 || *it == 3 || *it == 5)
+          _array.remove(it);
+      }
+
+      REQUIRE(2 == _array.size());
+      REQUIRE(_array[0] == 1);
+      REQUIRE(_array[1] == 4);
+
+      _array.add(6);
+      REQUIRE(_array[2] == 6);
+    }
+  }
 }
@@ -0,0 +1,212 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <stdlib.h>  // malloc, free
+#include <string.h>  // memcpy, memset
+#include <string>
+
+static const char json[] =
+    "{\"name\":\"reference\",\"values\":[1,-2,3.5,true,null],"
+    "\"nested\":{\"a\":[{\"b\":\"c\"}],\"raw\":[1,2]}}";
+
+static std::string toJson(JsonVariantConst v) {
+  std::string s;
+  serializeJson(v, s);
+  return s;
+}
+
+using ARDUINOJSON_NAMESPACE::DocumentImageHeader;
+using ARDUINOJSON_NAMESPACE::VariantData;
+using ARDUINOJSON_NAMESPACE::VariantSlot;
+
+// Right after saveDocumentImage(), the pointers of the image point to itself
+static VariantData* rootOf(void* image) {
+  return reinterpret_cast<VariantData*>(static_cast<char*>(image) +
+                                        DocumentImageHeader::rootOffset());
+}
+
+static void requireRejected(void* image, size_t size) {
+  DynamicJsonDocument copy(4096);
+  DeserializationError err = loadDocumentImage(copy, image, size);
+
+  REQUIRE(err == DeserializationError::InvalidInput);
+  REQUIRE(copy.isNull());
+
+  JsonVariantConst root;
+  err = mapDocumentImage(image, size, root);
+
+  REQUIRE(err == DeserializationError::InvalidInput);
+  REQUIRE(root.isNull());
+}
+
+TEST_CASE("Document image") {
+  DynamicJsonDocument doc(4096);
+  deserializeJson(doc, std::string(json));
+  doc["nested"]["raw"] = serialized(std::string("[1,2]"));
+
+  size_t size = measureDocumentImage(doc);
+  void* image = malloc(size);
+
+  SECTION("saveDocumentImage() returns the measured size") {
+    REQUIRE(saveDocumentImage(doc, image, size) == size);
+  }
+
+  SECTION("saveDocumentImage() fails if the buffer is too small") {
+    REQUIRE(saveDocumentImage(doc, image, size - 1) == 0);
+  }
+
+  SECTION("saveDocumentImage() fails with linked strings") {
+    doc["linked"] = "hello";
+
+    REQUIRE(saveDocumentImage(doc, image, size) == 0);
+  }
+
+  SECTION("saveDocumentImage() fails with a zero-copy input") {
+    char input[] = "{\"hello\":\"world\"}";
+    deserializeJson(doc, input);
+
+    REQUIRE(saveDocumentImage(doc, image, size) == 0);
+  }
+
+  SECTION("loadDocumentImage()") {
+    saveDocumentImage(doc, image, size);
+    DynamicJsonDocument copy(4096);
+
+    DeserializationError err = loadDocumentImage(copy, image, size);
+    memset(image, '#', size);  // the copy doesn't depend on the image
+    doc.clear();
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(toJson(copy.as<JsonVariant>()) == json);
+    REQUIRE(copy["nested"]["a"][0]["b"] == "c");
+  }
+
+  SECTION("loadDocumentImage() fails if the document is too small") {
+    saveDocumentImage(doc, image, size);
+    DynamicJsonDocument copy(64);
+
+    DeserializationError err = loadDocumentImage(copy, image, size);
+
+    REQUIRE(err == DeserializationError::NoMemory);
+    REQUIRE(copy.isNull());
+  }
+
+  SECTION("loadDocumentImage() fails with a truncated image") {
+    saveDocumentImage(doc, image, size);
+    DynamicJsonDocument copy(4096);
+
+    DeserializationError err = loadDocumentImage(copy, image, size - 1);
+
+    REQUIRE(err == DeserializationError::InvalidInput);
+  }
+
+  SECTION("loadDocumentImage() fails with a bad header") {
+    saveDocumentImage(doc, image, size);
+    static_cast<char*>(image)[0] = 'X';
+    DynamicJsonDocument copy(4096);
+
+    DeserializationError err = loadDocumentImage(copy, image, size);
+
+    REQUIRE(err == DeserializationError::InvalidInput);
+  }
+
+  SECTION("mapDocumentImage() at another address") {
+    saveDocumentImage(doc, image, size);
+    void* moved = malloc(size);
+    memcpy(moved, image, size);
+    memset(image, '#', size);
+    JsonVariantConst root;
+
+    DeserializationError err = mapDocumentImage(moved, size, root);
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(toJson(root) == json);
+
+    // the image can be mapped again
+    err = mapDocumentImage(moved, size, root);
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(toJson(root) == json);
+    free(moved);
+  }
+
+  SECTION("mapDocumentImage() fails with a truncated image") {
+    saveDocumentImage(doc, image, size);
+    JsonVariantConst root;
+
+    DeserializationError err = mapDocumentImage(image, size - 1, root);
+
+    REQUIRE(err == DeserializationError::InvalidInput);
+    REQUIRE(root.isNull());
+  }
+
+  SECTION("mapDocumentImage() keeps failing with a corrupt image") {
+    DynamicJsonDocument str(64);
+    str.set(std::string("hello"));
+    size_t strSize = saveDocumentImage(str, image, size);
+    REQUIRE(strSize > 0);
+    // make the root point outside of the pool
+    char* bytes = static_cast<char*>(image);
+    const char* strings = bytes + DocumentImageHeader::poolOffset();
+    const char* outside = "hello";
+    for (size_t i = DocumentImageHeader::rootOffset();
+         i < DocumentImageHeader::poolOffset(); i += sizeof(void*)) {
+      if (!memcmp(bytes + i, &strings, sizeof(strings)))
+        memcpy(bytes + i, &outside, sizeof(outside));
+    }
+    void* moved = malloc(strSize);
+    memcpy(moved, image, strSize);
+    JsonVariantConst root;
+
+    DeserializationError err = mapDocumentImage(moved, strSize, root);
+
+    REQUIRE(err == DeserializationError::InvalidInput);
+    REQUIRE(root.isNull());
+
+    err = mapDocumentImage(moved, strSize, root);
+
+    REQUIRE(err == DeserializationError::InvalidInput);
+    REQUIRE(root.isNull());
+    REQUIRE(memcmp(moved, image, strSize) == 0);  // left untouched
+    free(moved);
+  }
+
+  SECTION("Images with a link outside of the variants are rejected") {
+    saveDocumentImage(doc, image, size);
+    VariantData* root = rootOf(image);
+    VariantSlot* head = root->asObject()->head();
+    head->setNextNotNull(reinterpret_cast<VariantSlot*>(root));
+
+    requireRejected(image, size);
+  }
+
+  SECTION("Images with a string outside of the strings are rejected") {
+    saveDocumentImage(doc, image, size);
+    DocumentImageHeader header;
+    REQUIRE(DocumentImageHeader::read(header, image, size));
+    const char* strings =
+        static_cast<char*>(image) + DocumentImageHeader::poolOffset();
+    VariantSlot* head = rootOf(image)->asObject()->head();
+    head->data()->setOwnedString(strings + header.stringsSize);
+
+    requireRejected(image, size);
+  }
+
+  SECTION("Image of a null document") {
+    DynamicJsonDocument empty(0);
+    size_t emptySize = measureDocumentImage(empty);
+    REQUIRE(saveDocumentImage(empty, image, size) == emptySize);
+    DynamicJsonDocument copy(0);
+
+    DeserializationError err = loadDocumentImage(copy, image, emptySize);
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(copy.isNull());
+  }
+
+  free(image);
+}
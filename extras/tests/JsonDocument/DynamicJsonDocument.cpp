@@ -4,6 +4,7 @@
 
 #include <ArduinoJson.h>
 #include <catch.hpp>
+#include <string.h>  // memset
 
 using ARDUINOJSON_NAMESPACE::addPadding;
 
@@ -94,6 +95,35 @@ TEST_CASE("DynamicJsonDocument constructor") {
     REQUIRE(doc2.capacity() == doc1.capacity());
   }
 
+  SECTION("Copy constructor copies nested values") {
+    DynamicJsonDocument doc1(1234);
+    doc1["linked"] = "hello";
+    doc1[std::string("owned")] = std::string("world");
+    doc1["array"].add(std::string("a"));
+    doc1["array"].add(serialized(std::string("[1]")));
+
+    DynamicJsonDocument doc2 = doc1;
+    doc1.clear();
+    deserializeJson(doc1, "{\"overwritten\":\"strings\"}");
+
+    REQUIRE_JSON(doc2,
+                 "{\"linked\":\"hello\",\"owned\":\"world\","
+                 "\"array\":[\"a\",[1]]}");
+    REQUIRE(doc2.memoryUsage() ==
+            JSON_OBJECT_SIZE(3) + JSON_ARRAY_SIZE(2) + 6 + 6 + 2 + 3);
+  }
+
+  SECTION("Copy constructor doesn't depend on a zero-copy input") {
+    char input[] = "{\"hello\":\"world\"}";
+    DynamicJsonDocument doc1(1234);
+    deserializeJson(doc1, input);
+
+    DynamicJsonDocument doc2 = doc1;
+    memset(input, '#', sizeof(input) - 1);
+
+    REQUIRE_JSON(doc2, "{\"hello\":\"world\"}");
+  }
+
   SECTION("Construct from StaticJsonDocument") {
     StaticJsonDocument<200> doc1;
     deserializeJson(doc1, "{\"hello\":\"world\"}");
@@ -128,6 +128,12 @@ TEST_CASE("BasicJsonDocument::shrinkToFit()") {
     testShrinkToFit(doc, "{\"key\":\"abcdefg\"}", JSON_ARRAY_SIZE(1) + 8);
   }
 
+  SECTION("zero-copy strings") {
+    char input[] = "{\"key\":\"hello\"}";
+    deserializeJson(doc, input);
+    testShrinkToFit(doc, "{\"key\":\"hello\"}", JSON_OBJECT_SIZE(1));
+  }
+
   SECTION("unaligned") {
     doc.add(std::string("?"));  // two bytes in the string pool
     REQUIRE(doc.memoryUsage() == JSON_OBJECT_SIZE(1) + 2);
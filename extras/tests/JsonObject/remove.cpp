@@ -56,6 +56,25 @@ TEST_CASE("JsonObject::remove()") {
       serializeJson(obj, result);
       REQUIRE("{\"a\":0,\"b\":1}" == result);
     }
+
+    SECTION("Remove first two while iterating") {
+      for (; it != obj.end(); ++it) {
+        if (it->value() != 2)
+          obj.remove(it);
+      }
+      serializeJson(obj, result);
+      REQUIRE("{\"c\":2}" == result);
+    }
+
+    SECTION("Remove last two while iterating") {
+      for (; it != obj.end(); ++it) {
+        if (it->value() != 0)
+          obj.remove(it);
+      }
+      obj["d"] = 3;
+      serializeJson(obj, result);
+      REQUIRE("{\"a\":0,\"d\":3}" == result);
+    }
   }
 
 #ifdef HAS_VARIABLE_LENGTH_ARRAY
@@ -0,0 +1,164 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <sstream>
+#include <string>
+
+TEST_CASE("JsonWriter") {
+  std::string output;
+
+  SECTION("Empty array") {
+    {
+      JsonWriter<std::string> json(output);
+      REQUIRE(json.beginArray());
+      REQUIRE(json.complete() == false);
+      REQUIRE(json.end());
+      REQUIRE(json.complete() == true);
+    }
+    REQUIRE(output == "[]");
+  }
+
+  SECTION("Array of values") {
+    {
+      JsonWriter<std::string> json(output);
+      json.beginArray();
+      json.value("hello");
+      json.value(42);
+      json.value(-42);
+      json.value(3.5);
+      json.value(true);
+      json.null();
+      json.value(static_cast<const char*>(0));
+      json.end();
+    }
+    REQUIRE(output == "[\"hello\",42,-42,3.5,true,null,null]");
+  }
+
+  SECTION("Nested collections") {
+    {
+      JsonWriter<std::string> json(output);
+      json.beginObject();
+      json.key("a");
+      json.beginArray();
+      json.beginObject();
+      json.key("b");
+      json.value(1);
+      json.key("c");
+      json.beginArray();
+      json.end();
+      json.end();
+      json.value(2);
+      json.end();
+      json.key(std::string("d"));
+      json.value(std::string("e"));
+      json.end();
+    }
+    REQUIRE(output == "{\"a\":[{\"b\":1,\"c\":[]},2],\"d\":\"e\"}");
+  }
+
+  SECTION("Same output as serializeJson()") {
+    DynamicJsonDocument doc(4096);
+    deserializeJson(doc, "{\"x\":[1,\"two\\n\",{\"y\":null}],\"z\":false}");
+    {
+      JsonWriter<std::string> json(output);
+      json.beginObject();
+      json.key("x");
+      json.beginArray();
+      json.value(1);
+      json.value("two\n");
+      json.beginObject();
+      json.key("y");
+      json.null();
+      json.end();
+      json.end();
+      json.key("z");
+      json.value(false);
+      json.end();
+      REQUIRE(json.bytesWritten() == measureJson(doc));
+    }
+    std::string expected;
+    serializeJson(doc, expected);
+    REQUIRE(output == expected);
+  }
+
+  SECTION("Raw value") {
+    {
+      JsonWriter<std::string> json(output);
+      json.beginArray();
+      json.value(serialized("{\"raw\":1}"));
+      json.value(serialized(std::string("[2]")));
+      json.end();
+    }
+    REQUIRE(output == "[{\"raw\":1},[2]]");
+  }
+
+  SECTION("Single value") {
+    {
+      JsonWriter<std::string> json(output);
+      REQUIRE(json.value(42));
+      REQUIRE(json.complete());
+      REQUIRE(json.value(43) == false);
+    }
+    REQUIRE(output == "42");
+  }
+
+  SECTION("Rejects value without key in object") {
+    {
+      JsonWriter<std::string> json(output);
+      json.beginObject();
+      REQUIRE(json.value(1) == false);
+      REQUIRE(json.beginArray() == false);
+      json.end();
+    }
+    REQUIRE(output == "{}");
+  }
+
+  SECTION("Rejects key outside of object") {
+    JsonWriter<std::string> json(output);
+    REQUIRE(json.key("a") == false);
+    json.beginArray();
+    REQUIRE(json.key("a") == false);
+  }
+
+  SECTION("Rejects two keys in a row") {
+    JsonWriter<std::string> json(output);
+    json.beginObject();
+    REQUIRE(json.key("a"));
+    REQUIRE(json.key("b") == false);
+  }
+
+  SECTION("Rejects end() after key") {
+    JsonWriter<std::string> json(output);
+    json.beginObject();
+    json.key("a");
+    REQUIRE(json.end() == false);
+  }
+
+  SECTION("Rejects end() without collection") {
+    JsonWriter<std::string> json(output);
+    REQUIRE(json.end() == false);
+  }
+
+  SECTION("Nesting limit") {
+    JsonWriter<std::string> json(output);
+    for (int i = 0; i < ARDUINOJSON_DEFAULT_NESTING_LIMIT; i++)
+      REQUIRE(json.beginArray());
+    REQUIRE(json.beginArray() == false);
+  }
+
+  SECTION("std::ostream") {
+    std::ostringstream os;
+    {
+      JsonWriter<std::ostream> json(os);
+      json.beginArray();
+      json.value(1);
+      json.end();
+      REQUIRE(json.bytesWritten() == 3);
+    }
+    REQUIRE(os.str() == "[1]");
+  }
+}
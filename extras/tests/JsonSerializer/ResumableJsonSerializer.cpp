@@ -0,0 +1,183 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <string>
+
+using ARDUINOJSON_NAMESPACE::JsonSerializer;
+using ARDUINOJSON_NAMESPACE::ResumableSerializer;
+
+// Counts the chars of the strings that go through the formatter
+static size_t scannedChars;
+
+template <typename TWriter>
+class CountingJsonSerializer : public JsonSerializer<TWriter> {
+ public:
+  CountingJsonSerializer(TWriter& writer) : JsonSerializer<TWriter>(writer) {}
+
+  void writeStringPart(const char* s, size_t n) {
+    scannedChars += n;
+    JsonSerializer<TWriter>::writeStringPart(s, n);
+  }
+};
+
+template <typename TSource>
+static std::string serializeInChunks(const TSource& source, size_t chunkSize) {
+  ResumableJsonSerializer serializer(source);
+  std::string result;
+  char buffer[64];
+  for (int i = 0; i < 10000 && !serializer.done(); i++) {
+    size_t n = serializer.next(buffer, chunkSize);
+    REQUIRE(n <= chunkSize);
+    result.append(buffer, n);
+  }
+  REQUIRE(serializer.done());
+  return result;
+}
+
+TEST_CASE("ResumableJsonSerializer") {
+  DynamicJsonDocument doc(4096);
+
+  SECTION("Same output as serializeJson() for any chunk size") {
+    deserializeJson(doc,
+                    "{\"hello\":[1,-2,3.5,true,null,\"a\\\"b\\n\"],"
+                    "\"empty\":{},\"none\":[],\"nested\":[[[\"deep\"]],{\"k\":"
+                    "\"a longer string that spans several chunks\"}]}");
+    doc["raw"] = serialized("[1,2]");
+    std::string expected;
+    serializeJson(doc, expected);
+
+    for (size_t chunkSize = 1; chunkSize <= 64; chunkSize++) {
+      CAPTURE(chunkSize);
+      REQUIRE(serializeInChunks(doc, chunkSize) == expected);
+    }
+  }
+
+  SECTION("Long strings, keys, and raw values") {
+    std::string text;
+    for (int i = 0; i < 50; i++) text += "a \"quoted\" word\n";
+    doc[text] = text;
+    doc["raw"] = serialized("[" + std::string(200, '1') + "]");
+    doc["escapes"] = std::string(100, '\n');
+    std::string expected;
+    serializeJson(doc, expected);
+
+    for (size_t chunkSize = 1; chunkSize <= 64; chunkSize++) {
+      CAPTURE(chunkSize);
+      REQUIRE(serializeInChunks(doc, chunkSize) == expected);
+    }
+  }
+
+  SECTION("Doesn't scan the strings again for each chunk") {
+    std::string text;
+    for (int i = 0; i < 1000; i++) text += "123456789\n";
+    DynamicJsonDocument big(16384);
+    REQUIRE(big.set(text));
+    ResumableSerializer<CountingJsonSerializer> serializer(big);
+    scannedChars = 0;
+    std::string result;
+    char buffer[16];
+
+    while (!serializer.done())
+      result.append(buffer, serializer.next(buffer, sizeof(buffer)));
+
+    std::string expected;
+    serializeJson(big, expected);
+    REQUIRE(result == expected);
+    // each call scans at most one slice again, and measures what fits, a slice
+    // being at most a chunk
+    REQUIRE(scannedChars <= text.size() + (expected.size() / 16 + 1) * 2 * 17);
+  }
+
+  SECTION("Doesn't scan a slice again when the buffer gets smaller") {
+    std::string text(4000, '\n');
+    DynamicJsonDocument big(8192);
+    REQUIRE(big.set(text));
+    ResumableSerializer<CountingJsonSerializer> serializer(big);
+    scannedChars = 0;
+    std::string result;
+    char buffer[4096];
+
+    // the first slice takes the room of this buffer, but only half fits
+    result.append(buffer, serializer.next(buffer, sizeof(buffer)));
+    while (!serializer.done())
+      result.append(buffer, serializer.next(buffer, 16));
+
+    std::string expected;
+    serializeJson(big, expected);
+    REQUIRE(result == expected);
+    REQUIRE(scannedChars < 5 * text.size());
+  }
+
+  SECTION("Fills the buffer") {
+    deserializeJson(doc, "[\"hello\",\"world\"]");
+    ResumableJsonSerializer serializer(doc);
+    char buffer[8];
+
+    REQUIRE(serializer.next(buffer, 8) == 8);
+    REQUIRE(std::string(buffer, 8) == "[\"hello\"");
+    REQUIRE(serializer.next(buffer, 8) == 8);
+    REQUIRE(std::string(buffer, 8) == ",\"world\"");
+    REQUIRE(serializer.done() == false);
+    REQUIRE(serializer.next(buffer, 8) == 1);
+    REQUIRE(buffer[0] == ']');
+    REQUIRE(serializer.done() == true);
+    REQUIRE(serializer.next(buffer, 8) == 0);
+  }
+
+  SECTION("Root value") {
+    doc.set("hello");
+    REQUIRE(serializeInChunks(doc, 2) == "\"hello\"");
+  }
+
+  SECTION("Null document") {
+    REQUIRE(serializeInChunks(doc, 3) == "null");
+  }
+
+  SECTION("JsonArray") {
+    JsonArray array = doc.to<JsonArray>();
+    array.add(1);
+    array.createNestedObject()["a"] = 2;
+    REQUIRE(serializeInChunks(array, 3) == "[1,{\"a\":2}]");
+  }
+
+  SECTION("JsonVariant") {
+    doc["a"]["b"] = 42;
+    REQUIRE(serializeInChunks(doc["a"], 1) == "{\"b\":42}");
+  }
+
+  SECTION("Supports ARDUINOJSON_DEFAULT_NESTING_LIMIT levels") {
+    JsonArray array = doc.to<JsonArray>();
+    for (int i = 1; i < ARDUINOJSON_DEFAULT_NESTING_LIMIT; i++)
+      array = array.createNestedArray();
+    std::string expected = std::string(ARDUINOJSON_DEFAULT_NESTING_LIMIT, '[') +
+                           std::string(ARDUINOJSON_DEFAULT_NESTING_LIMIT, ']');
+    ResumableJsonSerializer serializer(doc);
+    char buffer[256];
+
+    size_t n = serializer.next(buffer, sizeof(buffer));
+
+    REQUIRE(serializer.done());
+    REQUIRE_FALSE(serializer.failed());
+    REQUIRE(std::string(buffer, n) == expected);
+  }
+
+  SECTION("Fails when the document is too deep") {
+    JsonArray array = doc.to<JsonArray>();
+    for (int i = 0; i < ARDUINOJSON_DEFAULT_NESTING_LIMIT; i++)
+      array = array.createNestedArray();
+    ResumableJsonSerializer serializer(doc);
+    char buffer[256];
+
+    size_t n = serializer.next(buffer, sizeof(buffer));
+
+    REQUIRE(serializer.done());
+    REQUIRE(serializer.failed());
+    // the output stops before the collection that doesn't fit in the stack
+    REQUIRE(std::string(buffer, n) ==
+            std::string(ARDUINOJSON_DEFAULT_NESTING_LIMIT, '['));
+  }
+}
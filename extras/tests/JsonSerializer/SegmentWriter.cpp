@@ -0,0 +1,115 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <string>
+
+static std::string join(const SegmentWriter& writer) {
+  std::string s;
+  for (size_t i = 0; i < writer.size(); i++)
+    s.append(writer[i].data, writer[i].size);
+  return s;
+}
+
+static const char longString[] =
+    "this string is long enough to be referenced in place";
+
+TEST_CASE("SegmentWriter") {
+  OutputSegment segments[8];
+  char scratch[64];
+  SegmentWriter writer(segments, 8, scratch, sizeof(scratch));
+  DynamicJsonDocument doc(4096);
+
+  SECTION("Copies short values in a single segment") {
+    deserializeJson(doc, "{\"hello\":[1,2,3],\"world\":true}");
+
+    size_t n = serializeJson(doc, writer);
+
+    REQUIRE(n == measureJson(doc));
+    REQUIRE(writer.size() == 1);
+    REQUIRE(writer[0].data == scratch);
+    REQUIRE(join(writer) == "{\"hello\":[1,2,3],\"world\":true}");
+  }
+
+  SECTION("References long strings in place") {
+    doc["key"] = longString;
+
+    size_t n = serializeJson(doc, writer);
+
+    REQUIRE(writer.size() == 3);
+    REQUIRE(writer[1].data == longString);
+    REQUIRE(writer[1].size == sizeof(longString) - 1);
+    REQUIRE(join(writer) == std::string("{\"key\":\"") + longString + "\"}");
+    REQUIRE(n == measureJson(doc));
+  }
+
+  SECTION("References long raw values in place") {
+    std::string raw = "[" + std::string(100, '1') + "]";
+    doc["raw"] = serialized(raw);
+
+    serializeJson(doc, writer);
+
+    REQUIRE(writer.size() == 3);
+    REQUIRE(doc.memoryPool().owns(writer[1].data));
+    REQUIRE(join(writer) == "{\"raw\":" + raw + "}");
+  }
+
+  SECTION("References long strings in MsgPack") {
+    doc.add(longString);
+
+    size_t n = serializeMsgPack(doc, writer);
+
+    REQUIRE(n == 2 + sizeof(longString) - 1 + 1);
+    REQUIRE(writer.size() == 2);
+    REQUIRE(writer[1].data == longString);
+  }
+
+  SECTION("Stops when the scratch buffer is full") {
+    for (int i = 0; i < 100; i++) doc.add(i);
+
+    size_t n = serializeJson(doc, writer);
+
+    REQUIRE(n == sizeof(scratch));
+    REQUIRE(writer.size() == 1);
+    REQUIRE(writer.overflowed() == true);
+  }
+
+  SECTION("Ignores long strings after the scratch buffer is full") {
+    for (int i = 0; i < 30; i++) doc.add(i);
+    doc.add(longString);
+    doc.add(1);
+
+    size_t n = serializeJson(doc, writer);
+
+    REQUIRE(n == sizeof(scratch));
+    REQUIRE(writer.size() == 1);
+    REQUIRE(join(writer) ==
+            "[0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,21,22,23,2");
+  }
+
+  SECTION("Stops when there are no more segments") {
+    for (int i = 0; i < 10; i++) doc.add(longString);
+
+    size_t n = serializeJson(doc, writer);
+
+    REQUIRE(writer.size() == 8);
+    REQUIRE(n < measureJson(doc));
+    REQUIRE(writer.overflowed() == true);
+    REQUIRE(join(writer).size() == n);
+  }
+
+  SECTION("clear()") {
+    doc.add(1);
+    serializeJson(doc, writer);
+
+    writer.clear();
+    serializeJson(doc, writer);
+
+    REQUIRE(writer.size() == 1);
+    REQUIRE(writer.overflowed() == false);
+    REQUIRE(join(writer) == "[1]");
+  }
+}
@@ -34,3 +34,45 @@ TEST_CASE("serializeJson(JsonVariantSubscript)") {
 
   REQUIRE(result == "42");
 }
+
+TEST_CASE("serializeJson(char[])") {
+  DynamicJsonDocument doc(4096);
+  deserializeJson(doc, "[\"hello\",42]");
+  char buffer[16];
+  memset(buffer, '*', sizeof(buffer));
+
+  SECTION("Terminates the string") {
+    size_t n = serializeJson(doc, buffer);
+
+    REQUIRE(n == 12);
+    REQUIRE(std::string(buffer) == "[\"hello\",42]");
+    REQUIRE(buffer[13] == '*');  // only one terminator
+  }
+
+  SECTION("Truncates the output") {
+    size_t n = serializeJson(doc, buffer, 8);
+
+    REQUIRE(n == 7);
+    REQUIRE(std::string(buffer) == "[\"hello");
+  }
+
+  SECTION("Writes nothing in an empty buffer") {
+    size_t n = serializeJson(doc, buffer, 0);
+
+    REQUIRE(n == 0);
+    REQUIRE(buffer[0] == '*');
+  }
+}
+
+TEST_CASE("serializeJson(std::string) with a long document") {
+  DynamicJsonDocument doc(4096);
+  for (int i = 0; i < 100; i++) doc.add(i);
+  std::string result;
+
+  size_t n = serializeJson(doc, result);
+
+  REQUIRE(n == result.size());
+  REQUIRE(result.size() == 291);
+  REQUIRE(result.substr(0, 10) == "[0,1,2,3,4");
+  REQUIRE(result.substr(281) == ",97,98,99]");
+}
@@ -3,6 +3,7 @@
 // MIT License
 
 #include <ArduinoJson/Memory/MemoryPool.hpp>
+#include <ArduinoJson/StringStorage/StringCopier.hpp>
 #include <catch.hpp>
 
 using namespace ARDUINOJSON_NAMESPACE;
@@ -32,6 +33,13 @@ TEST_CASE("MemoryPool::allocFrozenString()") {
     REQUIRE(0 == p);
   }
 
+  SECTION("Returns NULL when the size would wrap around") {
+    pool.allocFrozenString(1);
+
+    REQUIRE(0 == pool.allocFrozenString(size_t(-1)));
+    REQUIRE(0 == pool.allocFrozenString(size_t(-1) - 8));
+  }
+
   SECTION("Returns NULL when buffer is NULL") {
     MemoryPool pool2(0, poolCapacity);
     REQUIRE(0 == pool2.allocFrozenString(2));
@@ -65,3 +73,23 @@ TEST_CASE("MemoryPool::allocFrozenString()") {
     REQUIRE(a != 0);
   }
 }
+
+TEST_CASE("StringCopier::allocString()") {
+  char buffer[64];
+  MemoryPool pool(buffer, sizeof(buffer));
+  StringCopier copier(&pool);
+
+  SECTION("Reserves room for the terminator") {
+    REQUIRE(copier.allocString(63) != 0);
+    REQUIRE(pool.size() == 64);
+  }
+
+  SECTION("Returns NULL when the terminator doesn't fit") {
+    REQUIRE(copier.allocString(64) == 0);
+  }
+
+  SECTION("Returns NULL when n + 1 would wrap around") {
+    REQUIRE(copier.allocString(size_t(-1)) == 0);
+    REQUIRE(pool.size() == 0);
+  }
+}
@@ -48,3 +48,32 @@ TEST_CASE("MemoryPool::allocVariant()") {
     REQUIRE(pool.allocVariant() == 0);
   }
 }
+
+TEST_CASE("MemoryPool::allocVariants()") {
+  char buffer[4096];
+
+  SECTION("Returns contiguous slots below the previous ones") {
+    MemoryPool pool(buffer, sizeof(buffer));
+
+    VariantSlot* s1 = pool.allocVariant();
+    VariantSlot* s2 = pool.allocVariants(3);
+
+    REQUIRE(s2 + 3 == s1);
+    REQUIRE(isAligned(s2));
+    REQUIRE(pool.size() == 4 * sizeof(VariantSlot));
+  }
+
+  SECTION("Returns zero if capacity is insufficient") {
+    MemoryPool pool(buffer, 2 * sizeof(VariantSlot));
+
+    REQUIRE(pool.allocVariants(3) == 0);
+    REQUIRE(pool.size() == 0);
+    REQUIRE(pool.allocVariants(2) != 0);
+  }
+
+  SECTION("Returns zero if the size overflows") {
+    MemoryPool pool(buffer, sizeof(buffer));
+
+    REQUIRE(pool.allocVariants(size_t(-1) / 2) == 0);
+  }
+}
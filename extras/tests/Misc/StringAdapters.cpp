@@ -40,6 +40,7 @@ TEST_CASE("ConstRamStringAdapter") {
     CHECK_FALSE(adapter.equals("charlie"));
 
     CHECK(adapter.size() == 5);
+    CHECK(adapter[1] == 'r');
   }
 }
 
@@ -68,6 +69,7 @@ TEST_CASE("SizedRamStringAdapter") {
     CHECK_FALSE(adapter.equals("charlie"));
 
     CHECK(adapter.size() == 5);
+    CHECK(adapter[1] == 'r');
   }
 }
 
@@ -96,6 +98,7 @@ TEST_CASE("FlashStringAdapter") {
     CHECK_FALSE(adapter.equals("charlie"));
 
     CHECK(adapter.size() == 5);
+    CHECK(adapter[1] == 'r');
   }
 }
 
@@ -112,6 +115,7 @@ TEST_CASE("std::string") {
   CHECK_FALSE(adapter.equals("charlie"));
 
   CHECK(adapter.size() == 5);
+  CHECK(adapter[1] == 'r');
 }
 
 TEST_CASE("custom_string") {
@@ -127,6 +131,7 @@ TEST_CASE("custom_string") {
   CHECK_FALSE(adapter.equals("charlie"));
 
   CHECK(adapter.size() == 5);
+  CHECK(adapter[1] == 'r');
 }
 
 TEST_CASE("IsString<T>") {
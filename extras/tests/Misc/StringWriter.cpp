@@ -39,7 +39,7 @@ void common_tests(StringWriter& sb, const String& output) {
 }
 
 TEST_CASE("StaticStringWriter") {
-  char output[20];
+  char output[20] = {0};  // the writer doesn't add the terminator
   StaticStringWriter sb(output, sizeof(output));
 
   common_tests(sb, static_cast<const char*>(output));
@@ -54,7 +54,40 @@ TEST_CASE("StaticStringWriter") {
 TEST_CASE("Writer<std::string>") {
   std::string output;
   Writer<std::string> sb(output);
-  common_tests(sb, output);
+
+  SECTION("Writes characters to temporary buffer") {
+    // accumulate in buffer
+    sb.write('a');
+    sb.write('b');
+    sb.write('c');
+    sb.write('d');
+    REQUIRE(output == "");
+
+    // flush when full
+    sb.write('e');
+    REQUIRE(output == "abcde");
+
+    // flush on destruction
+    sb.write('f');
+    sb.~Writer();
+    REQUIRE(output == "abcdef");
+  }
+
+  SECTION("Writes short strings to temporary buffer") {
+    // accumulate in buffer
+    REQUIRE(3 == print(sb, "abc"));
+    REQUIRE(output == "");
+
+    // flush when full
+    REQUIRE(2 == print(sb, "de"));
+    REQUIRE(output == "abcde");
+  }
+
+  SECTION("Writes long strings directly") {
+    print(sb, "ab");
+    REQUIRE(6 == print(sb, "CDEFGH"));
+    REQUIRE(output == "abCDEFGH");
+  }
 }
 
 TEST_CASE("Writer<String>") {
@@ -97,9 +130,11 @@ TEST_CASE("Writer<String>") {
 
 TEST_CASE("Writer<custom_string>") {
   custom_string output;
-  Writer<custom_string> sb(output);
+  {
+    Writer<custom_string> sb(output);
+    REQUIRE(4 == print(sb, "ABCD"));
+  }  // flushes the buffer
 
-  REQUIRE(4 == print(sb, "ABCD"));
   REQUIRE("ABCD" == output);
 }
 
@@ -9,3 +9,11 @@ TEST_CASE("ARDUINOJSON_DECODE_UNICODE == 0") {
 
   REQUIRE(err == DeserializationError::NotSupported);
 }
+
+TEST_CASE("ARDUINOJSON_DECODE_UNICODE == 0 supports escaped ASCII") {
+  DynamicJsonDocument doc(2048);
+  DeserializationError err = deserializeJson(doc, "\"a\\u0001\\u0041\"");
+
+  REQUIRE(err == DeserializationError::Ok);
+  REQUIRE(doc.as<std::string>() == "a\x01" "A");
+}
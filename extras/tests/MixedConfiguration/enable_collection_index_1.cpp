@@ -0,0 +1,419 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#include "progmem_emulation.hpp"
+
+#define ARDUINOJSON_NAMESPACE ArduinoJson_CollectionIndex
+#define ARDUINOJSON_ENABLE_COLLECTION_INDEX 1
+#define ARDUINOJSON_COLLECTION_INDEX_THRESHOLD 4
+#define ARDUINOJSON_ENABLE_PROGMEM 1
+#include <ArduinoJson.h>
+
+#include <catch.hpp>
+#include <sstream>
+#include <stdlib.h>  // malloc, free
+
+static std::string keyOf(int i) {
+  std::ostringstream s;
+  s << "key" << i;
+  return s.str();
+}
+
+static void fill(JsonObject obj, int n) {
+  for (int i = 0; i < n; i++) obj[keyOf(i)] = i;
+}
+
+static bool checkAll(JsonObjectConst obj, int n, int skipModulo = 0) {
+  for (int i = 0; i < n; i++) {
+    bool removed = skipModulo && i % skipModulo == 0;
+    if (obj.containsKey(keyOf(i)) == removed)
+      return false;
+    if (!removed && obj[keyOf(i)] != i)
+      return false;
+  }
+  return true;
+}
+
+TEST_CASE("ARDUINOJSON_ENABLE_COLLECTION_INDEX == 1") {
+  DynamicJsonDocument doc(16384);
+  JsonObject obj = doc.to<JsonObject>();
+
+  SECTION("Finds every member") {
+    fill(obj, 100);
+
+    REQUIRE(obj.size() == 100);
+    REQUIRE(checkAll(obj, 100));
+    REQUIRE(obj["key100"].isNull());
+    REQUIRE(obj.containsKey("key42"));
+    REQUIRE(obj.containsKey(F("key42")));
+    REQUIRE(obj[F("key99")] == 99);
+  }
+
+  SECTION("Doesn't duplicate existing members") {
+    fill(obj, 50);
+    fill(obj, 50);
+
+    REQUIRE(obj.size() == 50);
+    REQUIRE(checkAll(obj, 50));
+  }
+
+  SECTION("Updates the index when removing members") {
+    fill(obj, 100);
+
+    for (int i = 0; i < 100; i += 3) obj.remove(keyOf(i));
+
+    REQUIRE(obj.size() == 66);
+    REQUIRE(checkAll(obj, 100, 3));
+  }
+
+  SECTION("Updates the index when removing through an iterator") {
+    fill(obj, 20);
+
+    for (JsonObject::iterator it = obj.begin(); it != obj.end(); ++it) {
+      if (it->key() == "key10") {
+        obj.remove(it);
+        break;
+      }
+    }
+
+    REQUIRE(obj.size() == 19);
+    REQUIRE_FALSE(obj.containsKey("key10"));
+    REQUIRE(obj["key11"] == 11);
+  }
+
+  SECTION("Returns the first of duplicated keys") {
+    DeserializationError err = deserializeMsgPack(
+        doc, "\x86\xA1\x61\x01\xA1\x62\x02\xA1\x63\x03\xA1\x64\x04\xA1\x61"
+             "\x05\xA1\x65\x06");
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(doc["a"] == 1);
+    REQUIRE(doc["e"] == 6);
+
+    doc.remove("a");
+
+    REQUIRE(doc["a"] == 5);
+  }
+
+  SECTION("deserializeJson()") {
+    DeserializationError err = deserializeJson(
+        doc, "{\"a\":1,\"b\":2,\"c\":3,\"d\":4,\"e\":5,\"f\":6,\"a\":7}");
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(doc.size() == 6);
+    REQUIRE(doc["a"] == 7);
+    REQUIRE(doc["f"] == 6);
+  }
+
+  SECTION("deserializeMsgPack()") {
+    DeserializationError err = deserializeMsgPack(
+        doc, "\x86\xA1" "a\x01\xA1" "b\x02\xA1" "c\x03\xA1" "d\x04\xA1"
+             "e\x05\xA1" "f\x06");
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(doc.size() == 6);
+    REQUIRE(doc["a"] == 1);
+    REQUIRE(doc["f"] == 6);
+    REQUIRE(doc["g"].isNull());
+  }
+
+  SECTION("Keeps working after copy") {
+    fill(obj, 100);
+
+    DynamicJsonDocument copy(doc);
+
+    REQUIRE(checkAll(copy.as<JsonObject>(), 100));
+  }
+
+  SECTION("Keeps working after shrinkToFit()") {
+    fill(obj, 100);
+
+    doc.shrinkToFit();
+
+    REQUIRE(checkAll(doc.as<JsonObject>(), 100));
+  }
+
+  SECTION("Keeps working after loadDocumentImage()") {
+    fill(obj, 100);
+    for (int i = 0; i < 100; i += 3) obj.remove(keyOf(i));
+    size_t size = measureDocumentImage(doc);
+    void* image = malloc(size);
+    saveDocumentImage(doc, image, size);
+    DynamicJsonDocument copy(16384);
+
+    DeserializationError err = loadDocumentImage(copy, image, size);
+    free(image);
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(checkAll(copy.as<JsonObject>(), 100, 3));
+  }
+
+  SECTION("Falls back to linear search when the pool is full") {
+    DynamicJsonDocument small(JSON_OBJECT_SIZE(5) + 5 * JSON_STRING_SIZE(5));
+
+    fill(small.to<JsonObject>(), 5);
+
+    REQUIRE(small.size() == 5);
+    REQUIRE(checkAll(small.as<JsonObject>(), 5));
+    // no retry for each member
+    REQUIRE(small.memoryPool().indexFailed(small.data().asObject()->head()));
+  }
+
+  SECTION("Indexes a small object after the index of a large one didn't fit") {
+    // the capacity leaves no room for the last index of the large object
+    fill(obj["large"].to<JsonObject>(), 33);
+    DynamicJsonDocument small(doc.memoryUsage() - JSON_OBJECT_SIZE(1));
+    JsonObject large = small.createNestedObject("large");
+    fill(large, 33);
+    JsonObject other = small.createNestedObject("other");
+
+    fill(other, 4);
+
+    // header + 8 entries, rounded to a whole number of slots
+    const size_t slotSize = JSON_OBJECT_SIZE(1);
+    const size_t indexSize =
+        (2 * sizeof(size_t) + 8 * sizeof(void*) + slotSize - 1) / slotSize *
+        slotSize;
+    REQUIRE(checkAll(large, 33));
+    REQUIRE(checkAll(other, 4));
+    REQUIRE(other.memoryUsage() ==
+            JSON_OBJECT_SIZE(4) + 4 * JSON_STRING_SIZE(5) + indexSize);
+  }
+
+  SECTION("memoryUsage() includes the index") {
+    fill(obj, 4);
+
+    // header + 8 entries, rounded to a whole number of slots
+    const size_t slotSize = JSON_OBJECT_SIZE(1);
+    const size_t indexSize =
+        (2 * sizeof(size_t) + 8 * sizeof(void*) + slotSize - 1) / slotSize *
+        slotSize;
+    REQUIRE(obj.memoryUsage() ==
+            JSON_OBJECT_SIZE(4) + 4 * JSON_STRING_SIZE(5) + indexSize);
+  }
+}
+
+static bool checkElements(JsonArrayConst arr, int n) {
+  if (arr.size() != size_t(n))
+    return false;
+  for (int i = 0; i < n; i++) {
+    if (arr[i] != i)
+      return false;
+  }
+  return arr[n].isNull();
+}
+
+TEST_CASE("ARDUINOJSON_ENABLE_COLLECTION_INDEX == 1 (arrays)") {
+  DynamicJsonDocument doc(16384);
+  JsonArray arr = doc.to<JsonArray>();
+  const size_t slotSize = JSON_ARRAY_SIZE(1);
+
+  SECTION("add()") {
+    for (int i = 0; i < 100; i++) arr.add(i);
+
+    REQUIRE(checkElements(arr, 100));
+  }
+
+  SECTION("operator[]") {
+    for (int i = 0; i < 100; i++) arr[i] = i;
+
+    REQUIRE(checkElements(arr, 100));
+  }
+
+  SECTION("operator[] past the end") {
+    for (int i = 0; i < 10; i++) arr.add(i);
+
+    arr[20] = 20;
+
+    REQUIRE(arr.size() == 21);
+    REQUIRE(arr[9] == 9);
+    REQUIRE(arr[15].isNull());
+    REQUIRE(arr[20] == 20);
+  }
+
+  SECTION("remove()") {
+    for (int i = 0; i < 100; i++) arr.add(i);
+
+    arr.remove(0);
+    arr.remove(50);
+    arr.remove(arr.begin());
+
+    REQUIRE(arr.size() == 97);
+    REQUIRE(arr[0] == 2);
+    REQUIRE(arr[48] == 50);
+    REQUIRE(arr[49] == 52);
+    REQUIRE(arr[96] == 99);
+  }
+
+  SECTION("remove(iterator) while iterating") {
+    for (int i = 0; i < 100; i++) arr.add(i);
+
+    for (JsonArray::iterator it = arr.begin(); it != arr.end(); ++it) {
+      if (it->as<int>() % 2 == 0)
+        arr.remove(it);
+    }
+
+    REQUIRE(arr.size() == 50);
+    for (int i = 0; i < 50; i++) REQUIRE(arr[i] == 2 * i + 1);
+    REQUIRE(arr[50].isNull());
+  }
+
+  SECTION("Reads by index after remove()") {
+    for (int i = 0; i < 100; i++) arr.add(i);
+    arr.remove(0);
+    arr.remove(arr.begin());
+    arr.remove(50);
+
+    // unlink the slots, so that only the index can find them
+    doc.data().asArray()->head()->setNext(0);
+
+    REQUIRE(arr[0] == 2);
+    REQUIRE(arr[49] == 51);
+    REQUIRE(arr[50] == 53);
+    REQUIRE(arr[96] == 99);
+  }
+
+  SECTION("Writes by index after remove()") {
+    for (int i = 0; i < 100; i++) arr.add(i);
+    arr.remove(10);
+
+    arr[50] = 42;
+    arr.add(100);
+
+    REQUIRE(arr.size() == 100);
+    REQUIRE(arr[9] == 9);
+    REQUIRE(arr[10] == 11);
+    REQUIRE(arr[50] == 42);
+    REQUIRE(arr[98] == 99);
+    REQUIRE(arr[99] == 100);
+  }
+
+  SECTION("Adds elements after remove()") {
+    for (int i = 0; i < 100; i++) arr.add(i);
+    arr.remove(arr.begin());
+
+    arr.add(100);
+
+    REQUIRE(arr.size() == 100);
+    REQUIRE(arr[0] == 1);
+    REQUIRE(arr[99] == 100);
+  }
+
+  SECTION("reserve()") {
+    arr.reserve(100);
+    size_t usage = doc.memoryUsage();
+
+    for (int i = 0; i < 100; i++) arr.add(i);
+
+    REQUIRE(checkElements(arr, 100));
+    REQUIRE(doc.memoryUsage() == usage + JSON_ARRAY_SIZE(100));
+  }
+
+  SECTION("reserve() doesn't take more than the pool can hold") {
+    DynamicJsonDocument small(JSON_ARRAY_SIZE(40));
+    JsonArray array = small.to<JsonArray>();
+
+    array.reserve(1000);
+    int n = 0;
+    while (array.add(n)) n++;
+
+    // the index holds as many entries as slots fit without it, and the slots
+    // take the rest of the pool
+    const size_t entries = small.capacity() / (slotSize + sizeof(void*));
+    const size_t indexSize =
+        (2 * sizeof(size_t) + entries * sizeof(void*) + slotSize - 1) /
+        slotSize * slotSize;
+    REQUIRE(n == int((small.capacity() - indexSize) / slotSize));
+    REQUIRE(checkElements(array, n));
+  }
+
+  SECTION("Stops building an index once one didn't fit") {
+    DynamicJsonDocument small(JSON_ARRAY_SIZE(5));
+    JsonArray array = small.to<JsonArray>();
+
+    for (int i = 0; i < 5; i++) REQUIRE(array.add(i));
+
+    REQUIRE(small.memoryPool().indexFailed(small.data().asArray()->head()));
+    REQUIRE(checkElements(array, 5));
+  }
+
+  SECTION("reserve() works after the index of another array didn't fit") {
+    // the capacity leaves no room for the last index of the large array
+    JsonArray large = doc.to<JsonArray>().createNestedArray();
+    for (int i = 0; i < 19; i++) large.add(i);
+    DynamicJsonDocument small(doc.memoryUsage() - slotSize);
+    large = small.to<JsonArray>().createNestedArray();
+    for (int i = 0; i < 19; i++) large.add(i);
+    JsonArray other = small.as<JsonArray>().createNestedArray();
+
+    other.reserve(4);
+
+    // header + 4 entries, rounded to a whole number of slots
+    const size_t indexSize =
+        (2 * sizeof(size_t) + 4 * sizeof(void*) + slotSize - 1) / slotSize *
+        slotSize;
+    REQUIRE(checkElements(large, 19));
+    REQUIRE(other.memoryUsage() == indexSize);
+  }
+
+  SECTION("deserializeMsgPack() reserves the announced size") {
+    DeserializationError err = deserializeMsgPack(
+        doc, "\xDC\x00\x14\x00\x01\x02\x03\x04\x05\x06\x07\x08\x09\x0A\x0B"
+             "\x0C\x0D\x0E\x0F\x10\x11\x12\x13");
+
+    // header + 20 entries, rounded to a whole number of slots
+    const size_t indexSize =
+        (2 * sizeof(size_t) + 20 * sizeof(void*) + slotSize - 1) / slotSize *
+        slotSize;
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(checkElements(doc.as<JsonArray>(), 20));
+    REQUIRE(doc.memoryUsage() == JSON_ARRAY_SIZE(20) + indexSize);
+  }
+
+  SECTION("deserializeMsgPack() doesn't trust the announced size") {
+    DeserializationError err =
+        deserializeMsgPack(doc, "\xDD\xFF\xFF\xFF\xFF\x01", 6);
+
+    REQUIRE(err == DeserializationError::NoMemory);
+    REQUIRE(doc.memoryUsage() == 0);
+  }
+
+  SECTION("deserializeJson()") {
+    DeserializationError err = deserializeJson(
+        doc, "[0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19]");
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(checkElements(doc.as<JsonArray>(), 20));
+  }
+
+  SECTION("Keeps working after copy") {
+    for (int i = 0; i < 100; i++) arr.add(i);
+
+    DynamicJsonDocument copy(doc);
+
+    REQUIRE(checkElements(copy.as<JsonArray>(), 100));
+  }
+
+  SECTION("Keeps working after shrinkToFit()") {
+    for (int i = 0; i < 100; i++) arr.add(i);
+
+    doc.shrinkToFit();
+
+    REQUIRE(checkElements(doc.as<JsonArray>(), 100));
+  }
+
+  SECTION("Keeps working after loadDocumentImage()") {
+    for (int i = 0; i < 100; i++) arr.add(i);
+    size_t size = measureDocumentImage(doc);
+    void* image = malloc(size);
+    saveDocumentImage(doc, image, size);
+    DynamicJsonDocument copy(16384);
+
+    DeserializationError err = loadDocumentImage(copy, image, size);
+    free(image);
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(checkElements(copy.as<JsonArray>(), 100));
+  }
+}
@@ -0,0 +1,116 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#define ARDUINOJSON_NAMESPACE ArduinoJson_InlineStrings
+#define ARDUINOJSON_ENABLE_INLINE_STRINGS 1
+#include <ArduinoJson.h>
+
+#include <catch.hpp>
+#include <string>
+
+static const char longString[] = "this string is too long to be inlined";
+
+TEST_CASE("ARDUINOJSON_ENABLE_INLINE_STRINGS == 1") {
+  DynamicJsonDocument doc(4096);
+
+  SECTION("set(std::string) doesn't use the pool for short strings") {
+    doc.set(std::string("hello"));
+
+    REQUIRE(doc.as<std::string>() == "hello");
+    REQUIRE(doc.is<const char*>());
+    REQUIRE(doc.memoryUsage() == 0);
+  }
+
+  SECTION("set(std::string) uses the pool for long strings") {
+    doc.set(std::string(longString));
+
+    REQUIRE(doc.as<std::string>() == longString);
+    REQUIRE(doc.memoryUsage() == JSON_STRING_SIZE(sizeof(longString)));
+  }
+
+  SECTION("set(char*) inlines the empty string") {
+    char s[] = "";
+    doc.set(s);
+
+    REQUIRE(doc.as<std::string>() == "");
+    REQUIRE(doc.memoryUsage() == 0);
+  }
+
+  SECTION("deserializeJson() reclaims the copy of short strings") {
+    DeserializationError err =
+        deserializeJson(doc, std::string("[\"hello\",\"world\",\"42\"]"));
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(doc[0] == "hello");
+    REQUIRE(doc[1] == "world");
+    REQUIRE(doc[2].as<int>() == 42);
+    REQUIRE(doc.memoryUsage() == JSON_ARRAY_SIZE(3));
+  }
+
+  SECTION("deserializeJson() keeps long strings in the pool") {
+    DeserializationError err = deserializeJson(
+        doc, std::string("{\"k\":\"") + longString + "\"}");
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(doc["k"] == longString);
+    REQUIRE(doc.memoryUsage() ==
+            JSON_OBJECT_SIZE(1) + JSON_STRING_SIZE(2) +
+                JSON_STRING_SIZE(sizeof(longString)));
+  }
+
+  SECTION("deserializeJson() in zero-copy mode") {
+    char input[] = "[\"hello\",\"world\"]";
+    DeserializationError err = deserializeJson(doc, input);
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(doc[0] == "hello");
+    REQUIRE(doc[1] == "world");
+  }
+
+  SECTION("deserializeMsgPack() reclaims the copy of short strings") {
+    DeserializationError err =
+        deserializeMsgPack(doc, std::string("\x92\xA5hello\xA3" "3.5", 11));
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(doc[0] == "hello");
+    REQUIRE(doc[1].as<double>() == 3.5);
+    REQUIRE(doc.memoryUsage() == JSON_ARRAY_SIZE(2));
+  }
+
+  SECTION("Compares with strings stored differently") {
+    doc["inline"] = std::string("hello");
+    doc["linked"] = "hello";
+    doc["owned"] = std::string(longString);
+    doc["linked_long"] = longString;
+
+    REQUIRE(doc["inline"] == doc["linked"]);
+    REQUIRE(doc["owned"] == doc["linked_long"]);
+    REQUIRE(doc["inline"] != doc["owned"]);
+  }
+
+  SECTION("Survives a copy") {
+    doc["a"] = std::string("hello");
+    DynamicJsonDocument copy(doc);
+
+    REQUIRE(copy["a"] == "hello");
+    REQUIRE(copy == doc);
+  }
+
+  SECTION("Survives shrinkToFit()") {
+    doc["a"] = std::string("hello");
+    doc["b"] = std::string(longString);
+    doc.shrinkToFit();
+
+    REQUIRE(doc["a"] == "hello");
+    REQUIRE(doc["b"] == longString);
+  }
+
+  SECTION("Serializes like any string") {
+    doc["a"] = std::string("hello");
+    std::string json;
+    serializeJson(doc, json);
+
+    REQUIRE(json == "{\"a\":\"hello\"}");
+  }
+}
@@ -0,0 +1,70 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#define ARDUINOJSON_NAMESPACE ArduinoJson_KeyInterning
+#define ARDUINOJSON_ENABLE_KEY_INTERNING 1
+#include <ArduinoJson.h>
+
+#include <catch.hpp>
+
+static const char* firstKey(JsonVariantConst object) {
+  return object.as<JsonObjectConst>().begin()->key().c_str();
+}
+
+TEST_CASE("ARDUINOJSON_ENABLE_KEY_INTERNING == 1") {
+  const size_t tableSize =
+      ARDUINOJSON_KEY_INTERNING_TABLE_SIZE * sizeof(const char*);
+  DynamicJsonDocument doc(4096);
+
+  SECTION("deserializeJson() stores repeated keys once") {
+    DeserializationError err = deserializeJson(
+        doc, std::string("[{\"id\":1,\"name\":2},{\"id\":3,\"name\":4}]"));
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(firstKey(doc[0]) == firstKey(doc[1]));
+    REQUIRE(doc[1]["name"] == 4);
+    REQUIRE(doc.memoryUsage() == JSON_ARRAY_SIZE(2) + 2 * JSON_OBJECT_SIZE(2) +
+                                     tableSize + JSON_STRING_SIZE(3) +
+                                     JSON_STRING_SIZE(5));
+  }
+
+  SECTION("deserializeMsgPack() stores repeated keys once") {
+    DeserializationError err = deserializeMsgPack(
+        doc, std::string("\x92\x81\xA2id\x01\x81\xA2id\x02", 11));
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(firstKey(doc[0]) == firstKey(doc[1]));
+    REQUIRE(doc[1]["id"] == 2);
+    REQUIRE(doc.memoryUsage() == JSON_ARRAY_SIZE(2) + 2 * JSON_OBJECT_SIZE(1) +
+                                     tableSize + JSON_STRING_SIZE(3));
+  }
+
+  SECTION("JsonObject::operator[] stores copied keys once") {
+    doc[0][std::string("hello")] = 1;
+    doc[1][std::string("hello")] = 2;
+
+    REQUIRE(firstKey(doc[0]) == firstKey(doc[1]));
+    REQUIRE(doc.memoryUsage() == JSON_ARRAY_SIZE(2) + 2 * JSON_OBJECT_SIZE(1) +
+                                     tableSize + JSON_STRING_SIZE(6));
+  }
+
+  SECTION("Keys remain valid after shrinkToFit()") {
+    deserializeJson(doc, std::string("[{\"id\":1},{\"id\":2}]"));
+
+    doc.shrinkToFit();
+
+    REQUIRE(firstKey(doc[0]) == firstKey(doc[1]));
+    std::string json;
+    serializeJson(doc, json);
+    REQUIRE(json == "[{\"id\":1},{\"id\":2}]");
+  }
+
+  SECTION("Doesn't intern keys stored in the input buffer") {
+    char input[] = "[{\"id\":1},{\"id\":2}]";
+    deserializeJson(doc, input);
+
+    REQUIRE(firstKey(doc[0]) != firstKey(doc[1]));
+    REQUIRE(doc.memoryUsage() == JSON_ARRAY_SIZE(2) + 2 * JSON_OBJECT_SIZE(1));
+  }
+}
@@ -0,0 +1,108 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#define ARDUINOJSON_NAMESPACE ArduinoJson_PoolStats
+#define ARDUINOJSON_ENABLE_POOL_STATS 1
+#include <ArduinoJson.h>
+
+#include <catch.hpp>
+#include <string>
+
+TEST_CASE("ARDUINOJSON_ENABLE_POOL_STATS == 1") {
+  DynamicJsonDocument doc(4096);
+  const MemoryPoolStats& stats = doc.memoryStats();
+
+  SECTION("Empty document") {
+    REQUIRE(stats.peakUsage == 0);
+    REQUIRE(stats.failedAllocations == 0);
+    REQUIRE(stats.reclaimedBytes == 0);
+    REQUIRE(stats.paddingBytes == 0);
+    REQUIRE(stats.slots == 0);
+    REQUIRE(stats.strings == 0);
+  }
+
+  SECTION("Counts slots and strings") {
+    deserializeJson(doc, "{\"a\":[1,2],\"b\":\"hello\"}");
+
+    REQUIRE(stats.slots == 4);
+    REQUIRE(stats.strings == 3);
+    REQUIRE(stats.peakUsage == doc.memoryUsage());
+  }
+
+  SECTION("Keeps the peak usage across clear()") {
+    deserializeJson(doc, "[1,2,3,4]");
+    size_t usage = doc.memoryUsage();
+    doc.clear();
+    deserializeJson(doc, "[1]");
+
+    REQUIRE(stats.peakUsage == usage);
+    REQUIRE(stats.slots == 1);
+  }
+
+  SECTION("Counts the strings reclaimed by the deserializer") {
+    StaticJsonDocument<JSON_OBJECT_SIZE(1)> filter;
+    filter["a"] = true;
+
+    DeserializationError err =
+        deserializeJson(doc, "{\"a\":1,\"hello\":2}",
+                        DeserializationOption::Filter(filter));
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(stats.reclaimedBytes == 6);  // "hello" was filtered out
+    REQUIRE(stats.strings == 1);
+  }
+
+  SECTION("Counts the failed allocations") {
+    StaticJsonDocument<JSON_ARRAY_SIZE(1)> small;
+
+    DeserializationError err = deserializeJson(small, "[1,2]");
+
+    REQUIRE(err == DeserializationError::NoMemory);
+    REQUIRE(small.memoryStats().failedAllocations == 1);
+    REQUIRE(small.memoryStats().slots == 1);
+  }
+
+  SECTION("Counts the strings that don't fit") {
+    StaticJsonDocument<JSON_OBJECT_SIZE(1)> small;
+
+    DeserializationError err = deserializeJson(small, "{\"hello\":1}");
+
+    REQUIRE(err == DeserializationError::NoMemory);
+    REQUIRE(small.memoryStats().failedAllocations == 1);
+  }
+
+  SECTION("Counts the padding of shrinkToFit()") {
+    doc["hello"] = std::string("world");
+
+    doc.shrinkToFit();
+
+    REQUIRE(stats.paddingBytes == 2);  // "world" is padded to 8 bytes
+    REQUIRE(doc.capacity() == doc.memoryUsage() + 2);
+  }
+
+  SECTION("resetMemoryStats()") {
+    deserializeJson(doc, "[1,2,3,4]");
+    doc.clear();
+    deserializeJson(doc, "[1]");
+
+    doc.resetMemoryStats();
+
+    REQUIRE(stats.peakUsage == doc.memoryUsage());
+    REQUIRE(stats.slots == 1);
+  }
+
+  SECTION("Copy keeps the peak usage of the destination") {
+    deserializeJson(doc, "[1,2,3,4]");
+    size_t usage = doc.memoryUsage();
+    doc.clear();
+    DynamicJsonDocument src(4096);
+    deserializeJson(src, "[\"hello\"]");
+
+    doc = src;
+
+    REQUIRE(stats.peakUsage == usage);
+    REQUIRE(stats.slots == 1);
+    REQUIRE(stats.strings == 1);
+  }
+}
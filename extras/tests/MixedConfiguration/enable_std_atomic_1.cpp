@@ -0,0 +1,122 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#define ARDUINOJSON_ENABLE_STD_ATOMIC 1
+#include <ArduinoJson.h>
+
+#include <catch.hpp>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+class SpyingAllocator {
+ public:
+  SpyingAllocator(const SpyingAllocator& src) : _log(src._log) {}
+  SpyingAllocator(std::ostream& log) : _log(log) {}
+
+  void* allocate(size_t n) {
+    _log << "A";
+    return malloc(n);
+  }
+  void deallocate(void* p) {
+    _log << "F";
+    free(p);
+  }
+
+ private:
+  SpyingAllocator& operator=(const SpyingAllocator& src);
+
+  std::ostream& _log;
+};
+}  // namespace
+
+TEST_CASE("JsonSnapshot") {
+  DynamicJsonDocument doc(4096);
+  deserializeJson(doc, "{\"name\":\"config\",\"values\":[1,2,3]}");
+
+  SECTION("Takes the content of the document") {
+    JsonSnapshot snapshot(std::move(doc));
+
+    REQUIRE(doc.isNull());
+    REQUIRE(doc.capacity() == 0);
+    REQUIRE(snapshot["name"] == "config");
+    REQUIRE(snapshot["values"][2] == 3);
+    REQUIRE(snapshot.size() == 2);
+    REQUIRE(snapshot.memoryUsage() > 0);
+  }
+
+  SECTION("Default constructed snapshot is null") {
+    JsonSnapshot snapshot;
+
+    REQUIRE(snapshot.isNull());
+    REQUIRE(snapshot["name"].isNull());
+    REQUIRE(snapshot.memoryUsage() == 0);
+  }
+
+  SECTION("Copies share the same pool") {
+    JsonSnapshot snapshot(std::move(doc));
+    JsonSnapshot copy = snapshot;
+
+    REQUIRE(copy["name"].as<const char*>() ==
+            snapshot["name"].as<const char*>());
+  }
+
+  SECTION("References remain valid while a copy exists") {
+    JsonVariantConst name;
+    JsonSnapshot copy;
+    {
+      JsonSnapshot snapshot(std::move(doc));
+      name = snapshot["name"];
+      copy = snapshot;
+    }
+
+    REQUIRE(name == "config");
+  }
+
+  SECTION("Can be serialized") {
+    JsonSnapshot snapshot(std::move(doc));
+    std::string json;
+    serializeJson(snapshot, json);
+
+    REQUIRE(json == "{\"name\":\"config\",\"values\":[1,2,3]}");
+  }
+
+  SECTION("Concurrent reads") {
+    JsonSnapshot snapshot(std::move(doc));
+    std::vector<std::thread> threads;
+    std::vector<int> sums(8);
+
+    for (size_t t = 0; t < sums.size(); t++) {
+      threads.push_back(std::thread([snapshot, &sums, t]() {
+        for (int i = 0; i < 1000; i++) {
+          JsonArrayConst values = snapshot["values"];
+          for (JsonVariantConst v : values) sums[t] += v.as<int>();
+          if (snapshot["name"] != "config")
+            sums[t] = -1;
+        }
+      }));
+    }
+    for (size_t t = 0; t < threads.size(); t++) threads[t].join();
+
+    for (size_t t = 0; t < sums.size(); t++) REQUIRE(sums[t] == 6000);
+  }
+}
+
+TEST_CASE("BasicJsonSnapshot") {
+  std::stringstream log;
+
+  SECTION("The last copy releases the pool") {
+    {
+      BasicJsonDocument<SpyingAllocator> doc(4096, log);
+      BasicJsonSnapshot<SpyingAllocator> snapshot(std::move(doc));
+      BasicJsonSnapshot<SpyingAllocator> copy(snapshot);
+      BasicJsonSnapshot<SpyingAllocator> other;
+      other = copy;
+      REQUIRE(log.str() == "AA");
+    }
+    REQUIRE(log.str() == "AAFF");
+  }
+}
@@ -0,0 +1,143 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#define ARDUINOJSON_ENABLE_STD_MUTEX 1
+#include <ArduinoJson.h>
+
+#include <catch.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+using ARDUINOJSON_NAMESPACE::addPadding;
+
+TEST_CASE("JsonDocumentPool") {
+  JsonDocumentPool pool(256, 1024);
+
+  SECTION("acquire() returns an empty document") {
+    JsonDocumentPool::Document* doc = pool.acquire();
+
+    REQUIRE(doc != 0);
+    REQUIRE(doc->isNull());
+    REQUIRE(doc->capacity() == 256);
+    pool.release(doc);
+  }
+
+  SECTION("Recycles the released documents") {
+    JsonDocumentPool::Document* doc1 = pool.acquire();
+    (*doc1)["hello"] = "world";
+    pool.release(doc1);
+
+    JsonDocumentPool::Document* doc2 = pool.acquire();
+
+    REQUIRE(doc2 == doc1);
+    REQUIRE(doc2->isNull());
+    REQUIRE(doc2->memoryUsage() == 0);
+    pool.release(doc2);
+  }
+
+  SECTION("Grows the documents that were too small") {
+    JsonDocumentPool::Document* doc = pool.acquire();
+    for (int i = 0; i < 100; i++) doc->add(i);
+    REQUIRE(doc->memoryUsage() <= 256);
+    pool.release(doc);
+
+    REQUIRE(pool.capacity() == 512);
+    doc = pool.acquire();
+    REQUIRE(doc->capacity() == 512);
+    pool.release(doc);
+  }
+
+  SECTION("Keeps the capacity of documents that were large enough") {
+    JsonDocumentPool::Document* doc = pool.acquire();
+    (*doc)["key"] = std::string(100, '*');
+    pool.release(doc);
+
+    REQUIRE(pool.capacity() == 256);
+  }
+
+  SECTION("Follows the high-water mark") {
+    DynamicJsonDocument big(1024);
+    big["key"] = std::string(600, '*');
+    JsonDocumentPool::Document* doc = pool.acquire();
+    *doc = big;  // reallocates the pool of the document
+    pool.release(doc);
+
+    REQUIRE(pool.capacity() == addPadding(big.memoryUsage()));
+  }
+
+  SECTION("Doesn't grow beyond maxCapacity()") {
+    JsonDocumentPool smallPool(256, 300);
+    JsonDocumentPool::Document* doc = smallPool.acquire();
+    for (int i = 0; i < 100; i++) doc->add(i);
+    smallPool.release(doc);
+
+    REQUIRE(smallPool.capacity() == addPadding(300));
+    doc = smallPool.acquire();
+    REQUIRE(doc->capacity() == addPadding(300));
+    smallPool.release(doc);
+  }
+
+  SECTION("Destroys the documents larger than maxCapacity()") {
+    DynamicJsonDocument big(2048);
+    big["key"] = std::string(1500, '*');
+    JsonDocumentPool::Document* doc = pool.acquire();
+    *doc = big;  // reallocates the pool of the document
+    REQUIRE(doc->capacity() > pool.maxCapacity());
+    pool.release(doc);
+
+    REQUIRE(pool.capacity() == 256);
+    doc = pool.acquire();
+    REQUIRE(doc->capacity() == 256);
+    pool.release(doc);
+  }
+
+  SECTION("maxCapacity() defaults to defaultGrowthFactor * capacity()") {
+    JsonDocumentPool defaultPool(256);
+    REQUIRE(defaultPool.maxCapacity() ==
+            JsonDocumentPool::defaultGrowthFactor * 256);
+
+    JsonDocumentPool::Document* doc = defaultPool.acquire();
+    for (int i = 0; i < 100; i++) doc->add(i);
+    defaultPool.release(doc);
+
+    REQUIRE(defaultPool.capacity() == 512);
+  }
+
+  SECTION("maxCapacity() == capacity() keeps the documents from growing") {
+    JsonDocumentPool fixedPool(256, 256);
+
+    JsonDocumentPool::Document* doc = fixedPool.acquire();
+    for (int i = 0; i < 100; i++) doc->add(i);
+    fixedPool.release(doc);
+
+    REQUIRE(fixedPool.capacity() == 256);
+  }
+
+  SECTION("release(0) does nothing") {
+    pool.release(0);
+  }
+
+  SECTION("Concurrent use") {
+    std::vector<std::thread> threads;
+    std::vector<int> errors(8);
+
+    for (size_t t = 0; t < errors.size(); t++) {
+      threads.push_back(std::thread([&pool, &errors, t]() {
+        for (int i = 0; i < 1000; i++) {
+          JsonDocumentPool::Document* doc = pool.acquire();
+          if (!doc || !doc->isNull())
+            errors[t]++;
+          deserializeJson(*doc, "{\"thread\":42}");
+          if ((*doc)["thread"] != 42)
+            errors[t]++;
+          pool.release(doc);
+        }
+      }));
+    }
+    for (size_t t = 0; t < threads.size(); t++) threads[t].join();
+
+    for (size_t t = 0; t < errors.size(); t++) REQUIRE(errors[t] == 0);
+  }
+}
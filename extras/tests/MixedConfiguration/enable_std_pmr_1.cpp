@@ -0,0 +1,150 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#define ARDUINOJSON_ENABLE_STD_PMR 1
+#include <ArduinoJson.h>
+
+#include <catch.hpp>
+#include <memory_resource>
+#include <string>
+
+using ARDUINOJSON_NAMESPACE::addPadding;
+
+// Counts the bytes in use, and checks that the blocks return to their resource
+class SpyingResource : public std::pmr::memory_resource {
+ public:
+  SpyingResource() : inUse(0) {}
+
+  size_t inUse;
+
+ private:
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    inUse += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+    REQUIRE(inUse >= bytes);
+    inUse -= bytes;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+  bool do_is_equal(const memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+static std::string toJson(const JsonDocument& doc) {
+  std::string s;
+  serializeJson(doc, s);
+  return s;
+}
+
+TEST_CASE("PmrJsonDocument") {
+  SpyingResource resource;
+
+  SECTION("Allocates from the resource") {
+    {
+      PmrJsonDocument doc(256, &resource);
+      REQUIRE(doc.capacity() == 256);
+      REQUIRE(resource.inUse > 256);
+      REQUIRE(doc.allocator().resource() == &resource);
+    }
+    REQUIRE(resource.inUse == 0);
+  }
+
+  SECTION("Works with monotonic_buffer_resource") {
+    char buffer[1024];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer),
+                                              std::pmr::null_memory_resource());
+    PmrJsonDocument doc(256, &arena);
+
+    deserializeJson(doc, "{\"hello\":\"world\"}");
+
+    REQUIRE(doc.capacity() == 256);
+    REQUIRE(doc["hello"] == "world");
+  }
+
+  SECTION("Capacity is 0 when the resource is exhausted") {
+    char buffer[128];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer),
+                                              std::pmr::null_memory_resource());
+    PmrJsonDocument doc(256, &arena);
+
+    REQUIRE(doc.capacity() == 0);
+  }
+
+  SECTION("Copy uses the same resource") {
+    {
+      PmrJsonDocument doc(256, &resource);
+      doc["hello"] = std::string("world");
+
+      PmrJsonDocument copy(doc);
+
+      REQUIRE(copy.allocator().resource() == &resource);
+      REQUIRE(toJson(copy) == "{\"hello\":\"world\"}");
+    }
+    REQUIRE(resource.inUse == 0);
+  }
+
+  SECTION("Move-assignment across resources") {
+    SpyingResource other;
+    {
+      PmrJsonDocument doc1(256, &resource);
+      doc1["hello"] = std::string("world");
+      PmrJsonDocument doc2(128, &other);
+
+      doc2 = std::move(doc1);
+
+      REQUIRE(toJson(doc2) == "{\"hello\":\"world\"}");
+      REQUIRE(other.inUse == 0);  // doc2 released its pool to "other"
+    }
+    // the pool of doc1 returned to "resource"
+    REQUIRE(resource.inUse == 0);
+    REQUIRE(other.inUse == 0);
+  }
+
+  SECTION("shrinkToFit()") {
+    {
+      PmrJsonDocument doc(4096, &resource);
+      doc["hello"] = std::string("world");
+      size_t before = resource.inUse;
+
+      doc.shrinkToFit();
+
+      REQUIRE(resource.inUse < before);  // the pool moved to a smaller block
+      REQUIRE(doc.capacity() == addPadding(doc.memoryUsage()));
+      REQUIRE(toJson(doc) == "{\"hello\":\"world\"}");
+    }
+    REQUIRE(resource.inUse == 0);
+  }
+
+  SECTION("shrinkToFit() keeps the block, if asked") {
+    {
+      PmrJsonDocument doc(4096, PmrAllocator(&resource, true));
+      doc["hello"] = std::string("world");
+      size_t before = resource.inUse;
+
+      doc.shrinkToFit();
+
+      REQUIRE(resource.inUse == before);
+      REQUIRE(doc.capacity() == addPadding(doc.memoryUsage()));
+      REQUIRE(toJson(doc) == "{\"hello\":\"world\"}");
+    }
+    REQUIRE(resource.inUse == 0);
+  }
+
+  SECTION("shrinkToFit() doesn't grow a monotonic_buffer_resource") {
+    std::pmr::monotonic_buffer_resource arena(&resource);
+    PmrJsonDocument doc(4096, PmrAllocator(&arena, true));
+    doc["hello"] = std::string("world");
+    size_t before = resource.inUse;
+
+    doc.shrinkToFit();
+
+    REQUIRE(resource.inUse == before);
+    REQUIRE(doc.capacity() == addPadding(doc.memoryUsage()));
+    REQUIRE(toJson(doc) == "{\"hello\":\"world\"}");
+  }
+}
@@ -0,0 +1,113 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#define ARDUINOJSON_ENABLE_STD_THREAD 1
+#include <ArduinoJson.h>
+
+#include <catch.hpp>
+#include <sstream>
+#include <string>
+
+using ARDUINOJSON_NAMESPACE::minElementsPerParallelThread;
+
+TEST_CASE("serializeJsonParallel()") {
+  DynamicJsonDocument doc(1024 * 1024);
+  std::string expected, actual;
+
+  SECTION("Large array") {
+    JsonArray array = doc.to<JsonArray>();
+    for (int i = 0; i < 10000; i++) {
+      if (i % 3 == 0)
+        array.add(i);
+      else if (i % 3 == 1)
+        array.add("hello\n");
+      else
+        array.createNestedObject()["value"] = i * 0.5;
+    }
+    serializeJson(doc, expected);
+
+    for (size_t threads = 0; threads <= 12; threads++) {
+      CAPTURE(threads);
+      actual.clear();
+      size_t n = serializeJsonParallel(doc, actual, threads);
+      REQUIRE(actual == expected);
+      REQUIRE(n == expected.size());
+    }
+  }
+
+  SECTION("Large object") {
+    JsonObject object = doc.to<JsonObject>();
+    for (int i = 0; i < 5000; i++) {
+      std::string key = "key" + std::to_string(i);
+      object[key] = i;
+    }
+    serializeJson(doc, expected);
+
+    serializeJsonParallel(doc, actual, 4);
+
+    REQUIRE(actual == expected);
+  }
+
+  SECTION("Exactly one range per thread") {
+    JsonArray array = doc.to<JsonArray>();
+    for (size_t i = 0; i < 3 * minElementsPerParallelThread; i++) array.add(1);
+    serializeJson(doc, expected);
+
+    serializeJsonParallel(doc, actual, 3);
+
+    REQUIRE(actual == expected);
+  }
+
+  SECTION("Small documents are serialized by the calling thread") {
+    deserializeJson(doc, "{\"hello\":[1,2,3]}");
+
+    serializeJsonParallel(doc, actual, 4);
+
+    REQUIRE(actual == "{\"hello\":[1,2,3]}");
+  }
+
+  SECTION("Root value") {
+    doc.set(42);
+
+    serializeJsonParallel(doc, actual, 4);
+
+    REQUIRE(actual == "42");
+  }
+
+  SECTION("JsonArray and std::ostream") {
+    JsonArray array = doc.to<JsonArray>();
+    for (int i = 0; i < 5000; i++) array.add(i);
+    serializeJson(array, expected);
+    std::ostringstream os;
+
+    serializeJsonParallel(array, os, 2);
+
+    REQUIRE(os.str() == expected);
+  }
+
+  SECTION("char[]") {
+    JsonArray array = doc.to<JsonArray>();
+    for (int i = 0; i < 5000; i++) array.add(i % 10);
+    serializeJson(doc, expected);
+    static char buffer[16384];
+
+    size_t n = serializeJsonParallel(doc, buffer, 4);
+
+    REQUIRE(n == expected.size());
+    REQUIRE(std::string(buffer) == expected);
+  }
+
+  SECTION("char* and size") {
+    JsonArray array = doc.to<JsonArray>();
+    for (int i = 0; i < 5000; i++) array.add(i % 10);
+    serializeJson(doc, expected);
+    static char buffer[16384];
+    char* p = buffer;
+
+    size_t n = serializeJsonParallel(doc, p, 101, 4);
+
+    REQUIRE(n == 100);
+    REQUIRE(std::string(buffer) == expected.substr(0, 100));
+  }
+}
@@ -0,0 +1,67 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#define ARDUINOJSON_NAMESPACE ArduinoJson_SlotOffsetSize1
+#define ARDUINOJSON_SLOT_OFFSET_SIZE 1
+#include <ArduinoJson.h>
+
+#include <catch.hpp>
+
+TEST_CASE("ARDUINOJSON_SLOT_OFFSET_SIZE == 1") {
+  DynamicJsonDocument doc(16384);
+  JsonArray arr = doc.to<JsonArray>();
+
+  SECTION("add() fails when the sibling is too far") {
+    JsonArray nested = arr.createNestedArray();
+    for (int i = 0; i < 128; i++) nested.add(i);
+
+    size_t poolSize = doc.memoryPool().size();
+
+    REQUIRE_FALSE(arr.add(42));
+    REQUIRE(arr.size() == 1);
+    REQUIRE(doc.memoryPool().size() == poolSize);  // the slot isn't lost
+  }
+
+  SECTION("deserializeJson() returns NoMemory") {
+    std::string json = "[[";
+    for (int i = 0; i < 127; i++) json += "0,";
+    json += "0],1]";
+
+    DeserializationError err = deserializeJson(doc, json);
+
+    REQUIRE(err == DeserializationError::NoMemory);
+  }
+
+  SECTION("remove() works when the neighbours are too far") {
+    JsonArray first = arr.createNestedArray();
+    for (int i = 0; i < 100; i++) first.add(i);
+    JsonArray second = arr.createNestedArray();
+    for (int i = 0; i < 50; i++) second.add(i);
+    REQUIRE(arr.add(42));
+
+    arr.remove(1);  // the first and the last are too far from each other
+
+    REQUIRE(arr.size() == 2);
+    REQUIRE(arr[0][99] == 99);
+    REQUIRE(arr[1] == 42);
+    REQUIRE(arr.add(43));
+    REQUIRE(arr[2] == 43);
+  }
+
+  SECTION("JsonObject::remove() works when the neighbours are too far") {
+    JsonObject obj = doc.to<JsonObject>();
+    JsonArray first = obj.createNestedArray("first");
+    for (int i = 0; i < 100; i++) first.add(i);
+    JsonArray second = obj.createNestedArray("second");
+    for (int i = 0; i < 50; i++) second.add(i);
+    obj["third"] = 3;
+
+    obj.remove("second");
+
+    REQUIRE(obj.size() == 2);
+    REQUIRE_FALSE(obj.containsKey("second"));
+    REQUIRE(obj["first"][99] == 99);
+    REQUIRE(obj["third"] == 3);
+  }
+}
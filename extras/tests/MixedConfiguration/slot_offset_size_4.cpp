@@ -0,0 +1,54 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#define ARDUINOJSON_NAMESPACE ArduinoJson_SlotOffsetSize4
+#define ARDUINOJSON_SLOT_OFFSET_SIZE 4
+#include <ArduinoJson.h>
+
+#include <catch.hpp>
+
+TEST_CASE("ARDUINOJSON_SLOT_OFFSET_SIZE == 4") {
+  // more than 32767 slots between two siblings
+  const int n = 40000;
+  DynamicJsonDocument doc(JSON_ARRAY_SIZE(3) + 2 * JSON_ARRAY_SIZE(n));
+
+  SECTION("JsonArray") {
+    JsonArray arr = doc.to<JsonArray>();
+    JsonArray nested = arr.createNestedArray();
+    for (int i = 0; i < n; i++) nested.add(i);
+
+    REQUIRE(arr.add(42));
+    REQUIRE(arr.size() == 2);
+    REQUIRE(arr[0].size() == n);
+    REQUIRE(arr[1] == 42);
+  }
+
+  SECTION("remove()") {
+    JsonArray arr = doc.to<JsonArray>();
+    JsonArray first = arr.createNestedArray();
+    JsonArray second = arr.createNestedArray();
+    for (int i = 0; i < n; i++) {
+      first.add(i);
+      second.add(i);
+    }
+    arr.add(42);
+
+    arr.remove(1);
+
+    REQUIRE(arr.size() == 2);
+    REQUIRE(arr[1] == 42);
+  }
+
+  SECTION("deserializeJson()") {
+    std::string json = "[[";
+    for (int i = 0; i < n; i++) json += "0,";
+    json += "0],1]";
+
+    DeserializationError err = deserializeJson(doc, json);
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(doc[0].size() == n + 1);
+    REQUIRE(doc[1] == 1);
+  }
+}
@@ -0,0 +1,266 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <string>
+
+#define MSGPACK(s) std::string(s, sizeof(s) - 1)
+
+static std::string bytes(const uint8_t* data, size_t size) {
+  return std::string(reinterpret_cast<const char*>(data), size);
+}
+
+static void checkRoundTrip(const std::string& input) {
+  DynamicJsonDocument doc(input.size() + 64);
+
+  DeserializationError error = deserializeMsgPack(doc, input);
+  std::string output;
+  serializeMsgPack(doc, output);
+
+  REQUIRE(error == DeserializationError::Ok);
+  REQUIRE(output == input);
+}
+
+TEST_CASE("deserializeMsgPack() with bin") {
+  DynamicJsonDocument doc(4096);
+
+  SECTION("bin 8") {
+    DeserializationError error =
+        deserializeMsgPack(doc, MSGPACK("\xc4\x03\x01\x00\x03"));
+    MsgPackBinary bin = doc.as<MsgPackBinary>();
+
+    REQUIRE(error == DeserializationError::Ok);
+    REQUIRE(doc.is<MsgPackBinary>() == true);
+    REQUIRE(doc.is<MsgPackExtension>() == false);
+    REQUIRE(doc.is<const char*>() == false);
+    REQUIRE(bytes(bin.data(), bin.size()) == MSGPACK("\x01\x00\x03"));
+    REQUIRE(doc.memoryUsage() == 4);
+  }
+
+  SECTION("empty bin 8") {
+    DeserializationError error = deserializeMsgPack(doc, MSGPACK("\xc4\x00"));
+    MsgPackBinary bin = doc.as<MsgPackBinary>();
+
+    REQUIRE(error == DeserializationError::Ok);
+    REQUIRE(bin.isNull() == false);
+    REQUIRE(bin.size() == 0);
+  }
+
+  SECTION("bin 16") {
+    DeserializationError error =
+        deserializeMsgPack(doc, MSGPACK("\xc5\x00\x02\xAB\xCD"));
+
+    REQUIRE(error == DeserializationError::Ok);
+    REQUIRE(doc.as<MsgPackBinary>().size() == 2);
+  }
+
+  SECTION("bin 32") {
+    DeserializationError error =
+        deserializeMsgPack(doc, MSGPACK("\xc6\x00\x00\x00\x02\xAB\xCD"));
+
+    REQUIRE(error == DeserializationError::Ok);
+    REQUIRE(doc.as<MsgPackBinary>().size() == 2);
+  }
+
+  SECTION("in an object") {
+    DeserializationError error =
+        deserializeMsgPack(doc, MSGPACK("\x82\xA1"
+                                        "a\xc4\x01\x2A\xA1"
+                                        "b\x01"));
+
+    REQUIRE(error == DeserializationError::Ok);
+    REQUIRE(doc["a"].as<MsgPackBinary>().data()[0] == 0x2A);
+    REQUIRE(doc["b"] == 1);
+  }
+
+  SECTION("incomplete") {
+    DeserializationError error =
+        deserializeMsgPack(doc, MSGPACK("\xc4\x03\x01\x02"));
+
+    REQUIRE(error == DeserializationError::IncompleteInput);
+  }
+
+  SECTION("NoMemory") {
+    StaticJsonDocument<8> small;
+    DeserializationError error = deserializeMsgPack(
+        small, MSGPACK("\xc4\x08\x01\x02\x03\x04\x05\x06\x07\x08"));
+
+    REQUIRE(error == DeserializationError::NoMemory);
+  }
+
+  SECTION("bin 32 with a size that wraps around") {
+    StaticJsonDocument<8> small;
+    DeserializationError error = deserializeMsgPack(
+        small, MSGPACK("\xc6\xff\xff\xff\xff") + std::string(64, '\x2A'));
+
+    REQUIRE(error == DeserializationError::NoMemory);
+  }
+
+  SECTION("serializeJson() writes null") {
+    deserializeMsgPack(doc, MSGPACK("\x91\xc4\x01\x2A"));
+
+    REQUIRE(doc.as<std::string>() == "[null]");
+  }
+
+  SECTION("round trip") {
+    checkRoundTrip(MSGPACK("\xc4\x00"));
+    checkRoundTrip(MSGPACK("\x92\xc4\x02\x00\x01\xc4\x01\xFF"));
+    checkRoundTrip(MSGPACK("\xc5\x01\x00") + std::string(256, '\x42'));
+    checkRoundTrip(MSGPACK("\xc6\x00\x01\x00\x00") + std::string(65536, 'x'));
+  }
+}
+
+TEST_CASE("deserializeMsgPack() with ext") {
+  DynamicJsonDocument doc(4096);
+
+  SECTION("fixext 1") {
+    DeserializationError error =
+        deserializeMsgPack(doc, MSGPACK("\xd4\x05\x2A"));
+    MsgPackExtension ext = doc.as<MsgPackExtension>();
+
+    REQUIRE(error == DeserializationError::Ok);
+    REQUIRE(doc.is<MsgPackExtension>() == true);
+    REQUIRE(doc.is<MsgPackBinary>() == false);
+    REQUIRE(ext.type() == 5);
+    REQUIRE(bytes(ext.data(), ext.size()) == "\x2A");
+    REQUIRE(doc.memoryUsage() == 2);
+  }
+
+  SECTION("fixext 4 with a negative type") {
+    DeserializationError error =
+        deserializeMsgPack(doc, MSGPACK("\xd6\xff\x00\x00\x00\x01"));
+    MsgPackExtension ext = doc.as<MsgPackExtension>();
+
+    REQUIRE(error == DeserializationError::Ok);
+    REQUIRE(ext.type() == -1);
+    REQUIRE(bytes(ext.data(), ext.size()) == MSGPACK("\x00\x00\x00\x01"));
+  }
+
+  SECTION("ext 8") {
+    DeserializationError error =
+        deserializeMsgPack(doc, MSGPACK("\xc7\x03\x01\x0A\x0B\x0C"));
+    MsgPackExtension ext = doc.as<MsgPackExtension>();
+
+    REQUIRE(error == DeserializationError::Ok);
+    REQUIRE(ext.type() == 1);
+    REQUIRE(bytes(ext.data(), ext.size()) == "\x0A\x0B\x0C");
+  }
+
+  SECTION("empty ext 8") {
+    DeserializationError error =
+        deserializeMsgPack(doc, MSGPACK("\xc7\x00\x01"));
+    MsgPackExtension ext = doc.as<MsgPackExtension>();
+
+    REQUIRE(error == DeserializationError::Ok);
+    REQUIRE(ext.isNull() == false);
+    REQUIRE(ext.type() == 1);
+    REQUIRE(ext.size() == 0);
+  }
+
+  SECTION("incomplete") {
+    DeserializationError error =
+        deserializeMsgPack(doc, MSGPACK("\xd6\x01\x00\x00"));
+
+    REQUIRE(error == DeserializationError::IncompleteInput);
+  }
+
+  SECTION("NoMemory") {
+    StaticJsonDocument<8> small;
+    DeserializationError error = deserializeMsgPack(
+        small, MSGPACK("\xc7\x08\x01\x01\x02\x03\x04\x05\x06\x07\x08"));
+
+    REQUIRE(error == DeserializationError::NoMemory);
+  }
+
+  SECTION("ext 32 with a size that wraps around") {
+    StaticJsonDocument<8> small;
+    DeserializationError error = deserializeMsgPack(
+        small,
+        MSGPACK("\xc9\xff\xff\xff\xff\x01") + std::string(64, '\x2A'));
+
+    REQUIRE(error == DeserializationError::NoMemory);
+  }
+
+  SECTION("round trip") {
+    checkRoundTrip(MSGPACK("\xd4\x01\x02"));
+    checkRoundTrip(MSGPACK("\xd5\x01\x02\x03"));
+    checkRoundTrip(MSGPACK("\xd6\x01\x02\x03\x04\x05"));
+    checkRoundTrip(MSGPACK("\xd7\x01") + std::string(8, '\x07'));
+    checkRoundTrip(MSGPACK("\xd8\x01") + std::string(16, '\x07'));
+    checkRoundTrip(MSGPACK("\xc7\x03\x01\x0A\x0B\x0C"));
+    checkRoundTrip(MSGPACK("\xc8\x01\x00\x80") + std::string(256, '\x07'));
+    checkRoundTrip(MSGPACK("\xc9\x00\x01\x00\x00\x80") +
+                   std::string(65536, '\x07'));
+  }
+}
+
+TEST_CASE("deserializeMsgPack() with bin and ext in a writable input") {
+  DynamicJsonDocument doc(4096);
+  char input[] = "\x92\xc4\x02\x01\x02\xd5\x03\x0A\x0B";
+
+  DeserializationError error = deserializeMsgPack(doc, input);
+  MsgPackBinary bin = doc[0].as<MsgPackBinary>();
+  MsgPackExtension ext = doc[1].as<MsgPackExtension>();
+
+  REQUIRE(error == DeserializationError::Ok);
+  REQUIRE(doc.memoryUsage() == JSON_ARRAY_SIZE(2));
+  REQUIRE(reinterpret_cast<const char*>(bin.data()) >= input);
+  REQUIRE(reinterpret_cast<const char*>(bin.data()) < input + sizeof(input));
+  REQUIRE(bytes(bin.data(), bin.size()) == "\x01\x02");
+  REQUIRE(ext.type() == 3);
+  REQUIRE(bytes(ext.data(), ext.size()) == "\x0A\x0B");
+}
+
+TEST_CASE("MsgPackBinary and MsgPackExtension in a JsonVariant") {
+  DynamicJsonDocument doc(4096);
+  const uint8_t data[] = {1, 2, 3};
+
+  SECTION("set(MsgPackBinary) copies the bytes") {
+    doc["bin"] = MsgPackBinary(data, sizeof(data));
+    MsgPackBinary bin = doc["bin"].as<MsgPackBinary>();
+
+    REQUIRE(bin.data() != data);
+    REQUIRE(bin.size() == 3);
+    REQUIRE(bytes(bin.data(), bin.size()) == "\x01\x02\x03");
+  }
+
+  SECTION("set(MsgPackExtension) copies the bytes") {
+    doc["ext"] = MsgPackExtension(-5, data, sizeof(data));
+    MsgPackExtension ext = doc["ext"].as<MsgPackExtension>();
+
+    REQUIRE(ext.data() != data);
+    REQUIRE(ext.type() == -5);
+    REQUIRE(bytes(ext.data(), ext.size()) == "\x01\x02\x03");
+  }
+
+  SECTION("set(MsgPackBinary()) sets null") {
+    doc["bin"] = MsgPackBinary();
+
+    REQUIRE(doc["bin"].isNull() == true);
+  }
+
+  SECTION("as<MsgPackBinary>() returns a null view for other types") {
+    doc["value"] = "hello";
+
+    REQUIRE(doc["value"].as<MsgPackBinary>().isNull() == true);
+    REQUIRE(doc["missing"].as<MsgPackBinary>().isNull() == true);
+    REQUIRE(doc["value"].as<MsgPackExtension>().isNull() == true);
+  }
+
+  SECTION("copy and compare") {
+    doc["bin"] = MsgPackBinary(data, sizeof(data));
+    doc["ext"] = MsgPackExtension(1, data, sizeof(data));
+
+    DynamicJsonDocument copy(doc);
+
+    REQUIRE(copy == doc);
+    REQUIRE(copy["bin"].as<MsgPackBinary>().data() !=
+            doc["bin"].as<MsgPackBinary>().data());
+
+    copy["ext"] = MsgPackExtension(2, data, sizeof(data));
+    REQUIRE(copy != doc);
+  }
+}
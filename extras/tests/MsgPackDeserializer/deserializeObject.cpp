@@ -127,4 +127,22 @@ TEST_CASE("deserialize MsgPack object") {
       REQUIRE(obj["pi"] == 3.14f);
     }
   }
+
+  SECTION("Keeps the complete members on error") {
+    SECTION("missing key") {
+      DeserializationError error =
+          deserializeMsgPack(doc, "\x83\xA1" "a\x01\xA1" "b\x02", 7);
+
+      REQUIRE(error == DeserializationError::IncompleteInput);
+      REQUIRE(doc.as<std::string>() == "{\"a\":1,\"b\":2}");
+    }
+
+    SECTION("missing value") {
+      DeserializationError error =
+          deserializeMsgPack(doc, "\x83\xA1" "a\x01\xA1" "b", 6);
+
+      REQUIRE(error == DeserializationError::IncompleteInput);
+      REQUIRE(doc.as<std::string>() == "{\"a\":1,\"b\":null}");
+    }
+  }
 }
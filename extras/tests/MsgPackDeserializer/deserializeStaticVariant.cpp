@@ -64,6 +64,10 @@ TEST_CASE("deserializeMsgPack(StaticJsonDocument&)") {
                     DeserializationError::Ok);
     checkString<16>("\xDB\x00\x00\x00\x10ZZZZZZZZZZZZZZZZ",
                     DeserializationError::NoMemory);
+
+    // the size + 1 must not wrap around on 32-bit targets
+    checkString<8>("\xDB\xFF\xFF\xFF\xFFZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZZ",
+                   DeserializationError::NoMemory);
   }
 
   SECTION("fixarray") {
@@ -149,4 +153,9 @@ TEST_CASE("deserializeMsgPack(StaticJsonDocument&)") {
           "\xDF\x00\x00\x00\x02\xA1H\x01\xA1W\x02", DeserializationError::Ok);
     }
   }
+
+  SECTION("NoMemory comes before the content") {
+    check<JSON_ARRAY_SIZE(1)>("\x92", DeserializationError::NoMemory);
+    check<JSON_OBJECT_SIZE(1)>("\x82", DeserializationError::NoMemory);
+  }
 }
@@ -0,0 +1,258 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <sstream>
+#include <string>
+
+// Keeps the null bytes of the literal
+#define MSGPACK(s) std::string(s, sizeof(s) - 1)
+
+TEST_CASE("deserializeMsgPack() with filter") {
+  struct TestCase {
+    std::string input;
+    const char* filter;
+    uint8_t nestingLimit;
+    DeserializationError error;
+    const char* output;
+    size_t memoryUsage;
+  };
+
+  // clang-format off
+  TestCase testCases[] = {
+    {
+      MSGPACK("\x81\xA5hello\xA5world"),  // 1. input = {"hello":"world"}
+      "null",                                 // 2. filter
+      10,                                     // 3. nestingLimit
+      DeserializationError::Ok,               // 4. error
+      "null",                                 // 5. output
+      0                                       // 6. memoryUsage
+    },
+    {
+      MSGPACK("\x81\xA7" "abcdefg" "\xA7" "hijklmn"),
+      "true",
+      10,
+      DeserializationError::Ok,
+      "{\"abcdefg\":\"hijklmn\"}",
+      JSON_OBJECT_SIZE(1) + 16
+    },
+    {
+      MSGPACK("\x81\xA5hello\xA5world"),
+      "{}",
+      10,
+      DeserializationError::Ok,
+      "{}",
+      JSON_OBJECT_SIZE(0)
+    },
+    {
+      // Input in an object, but filter wants an array
+      MSGPACK("\x81\xA5hello\xA5world"),
+      "[]",
+      10,
+      DeserializationError::Ok,
+      "null",
+      0
+    },
+    {
+      // Input is an array, but filter wants an object
+      MSGPACK("\x92\xA5hello\xA5world"),
+      "{}",
+      10,
+      DeserializationError::Ok,
+      "null",
+      0
+    },
+    {
+      // Keep only the members in the filter
+      MSGPACK("\x83\xA3one\x01\xA3two\xCD\x01\x00\xA5three\xC3"),
+      "{\"two\":true}",
+      10,
+      DeserializationError::Ok,
+      "{\"two\":256}",
+      JSON_OBJECT_SIZE(1) + 4
+    },
+    {
+      // Filter applies to all the elements of the array
+      MSGPACK("\x92\x82\xA1" "a\x01\xA1" "b\x02\x82\xA1" "a\x03\xA1" "b\x04"),
+      "[{\"a\":true}]",
+      10,
+      DeserializationError::Ok,
+      "[{\"a\":1},{\"a\":3}]",
+      JSON_ARRAY_SIZE(2) + 2 * JSON_OBJECT_SIZE(1) + 4
+    },
+    {
+      // Skip a nested object and array
+      MSGPACK("\x82\xA1x\x81\xA1y\x92\x01\x02\xA1z\x2A"),
+      "{\"z\":true}",
+      10,
+      DeserializationError::Ok,
+      "{\"z\":42}",
+      JSON_OBJECT_SIZE(1) + 2
+    },
+    {
+      // Skip the types that are not supported, like bin and ext
+      MSGPACK("\x86\xA1" "a\xC4\x02xy\xA1" "b\xD4\x01x\xA1" "c\xC7\x01\x01x"
+                  "\xA1" "d\xD8\x01" "0123456789ABCDEF\xA1" "e\xD3\0\0\0\0\0\0\0\0"
+                  "\xA1" "f\x01"),
+      "{\"f\":true}",
+      10,
+      DeserializationError::Ok,
+      "{\"f\":1}",
+      JSON_OBJECT_SIZE(1) + 2
+    },
+    {
+      // Skip long strings and collections
+      MSGPACK("\x83\xA1" "a\xD9\x03" "abc\xA1" "b\xDC\x00\x02\x01\x02\xA1"
+                  "c\xDE\x00\x01\xA1k\xA1v"),
+      "{\"c\":true}",
+      10,
+      DeserializationError::Ok,
+      "{\"c\":{\"k\":\"v\"}}",
+      2 * JSON_OBJECT_SIZE(1) + 6
+    },
+    {
+      // Skipped values count in the nesting limit
+      MSGPACK("\x82\xA1" "a\x91\x91\x01\xA1" "b\x01"),
+      "{\"b\":true}",
+      2,
+      DeserializationError::TooDeep,
+      "{}",
+      JSON_OBJECT_SIZE(0)
+    },
+    {
+      // Incomplete input in a skipped value
+      MSGPACK("\x82\xA1" "a\xA5hel"),
+      "{\"b\":true}",
+      10,
+      DeserializationError::IncompleteInput,
+      "{}",
+      JSON_OBJECT_SIZE(0)
+    },
+    {
+      // Skip a string longer than the skip buffer
+      MSGPACK("\x82\xA1" "a\xDA\x00\x64") + std::string(100, 'x') +
+          MSGPACK("\xA1" "f\x01"),
+      "{\"f\":true}",
+      10,
+      DeserializationError::Ok,
+      "{\"f\":1}",
+      JSON_OBJECT_SIZE(1) + 2
+    },
+    {
+      // The size of an ext 32 plus its type byte doesn't wrap around
+      MSGPACK("\x82\xA1" "a\xC9\xFF\xFF\xFF\xFF\x01\xA1" "f\x01"),
+      "{\"f\":true}",
+      10,
+      DeserializationError::IncompleteInput,
+      "{}",
+      JSON_OBJECT_SIZE(0)
+    },
+    {
+      // The number of values of a map 32 doesn't wrap around
+      MSGPACK("\x82\xA1" "a\xDF\x80\x00\x00\x00\xA1" "f\x01"),
+      "{\"f\":true}",
+      10,
+      DeserializationError::IncompleteInput,
+      "{}",
+      JSON_OBJECT_SIZE(0)
+    },
+    {
+      // Input is a number, but filter wants an object
+      MSGPACK("\x2A"),
+      "{}",
+      10,
+      DeserializationError::Ok,
+      "null",
+      0
+    },
+  };
+  // clang-format on
+
+  for (size_t i = 0; i < sizeof(testCases) / sizeof(testCases[0]); i++) {
+    CAPTURE(i);
+
+    DynamicJsonDocument filter(256);
+    DynamicJsonDocument doc(256);
+    TestCase& tc = testCases[i];
+
+    CAPTURE(tc.filter);
+    REQUIRE(deserializeJson(filter, tc.filter) == DeserializationError::Ok);
+
+    CHECK(deserializeMsgPack(doc, tc.input.data(), tc.input.size(),
+                             DeserializationOption::Filter(filter),
+                             DeserializationOption::NestingLimit(
+                                 tc.nestingLimit)) == tc.error);
+
+    CHECK(doc.as<std::string>() == tc.output);
+    CHECK(doc.memoryUsage() == tc.memoryUsage);
+  }
+}
+
+TEST_CASE("deserializeMsgPack() overloads with filter") {
+  StaticJsonDocument<256> doc;
+  StaticJsonDocument<256> filter;
+
+  using namespace DeserializationOption;
+
+  // deserializeMsgPack(..., Filter)
+
+  SECTION("const char*, Filter") {
+    deserializeMsgPack(doc, "\x80", Filter(filter));
+  }
+
+  SECTION("const char*, size_t, Filter") {
+    deserializeMsgPack(doc, "\x80", 1, Filter(filter));
+  }
+
+  SECTION("const std::string&, Filter") {
+    deserializeMsgPack(doc, std::string("\x80"), Filter(filter));
+  }
+
+  SECTION("std::istream&, Filter") {
+    std::stringstream s("\x80");
+    deserializeMsgPack(doc, s, Filter(filter));
+  }
+
+  // deserializeMsgPack(..., Filter, NestingLimit)
+
+  SECTION("const char*, Filter, NestingLimit") {
+    deserializeMsgPack(doc, "\x80", Filter(filter), NestingLimit(5));
+  }
+
+  SECTION("const char*, size_t, Filter, NestingLimit") {
+    deserializeMsgPack(doc, "\x80", 1, Filter(filter), NestingLimit(5));
+  }
+
+  SECTION("const std::string&, Filter, NestingLimit") {
+    deserializeMsgPack(doc, std::string("\x80"), Filter(filter),
+                       NestingLimit(5));
+  }
+
+  SECTION("std::istream&, Filter, NestingLimit") {
+    std::stringstream s("\x80");
+    deserializeMsgPack(doc, s, Filter(filter), NestingLimit(5));
+  }
+
+  // deserializeMsgPack(..., NestingLimit, Filter)
+
+  SECTION("const char*, NestingLimit, Filter") {
+    deserializeMsgPack(doc, "\x80", NestingLimit(5), Filter(filter));
+  }
+
+  SECTION("const char*, size_t, NestingLimit, Filter") {
+    deserializeMsgPack(doc, "\x80", 1, NestingLimit(5), Filter(filter));
+  }
+
+  SECTION("const std::string&, NestingLimit, Filter") {
+    deserializeMsgPack(doc, std::string("\x80"), NestingLimit(5),
+                       Filter(filter));
+  }
+
+  SECTION("std::istream&, NestingLimit, Filter") {
+    std::stringstream s("\x80");
+    deserializeMsgPack(doc, s, NestingLimit(5), Filter(filter));
+  }
+}
@@ -93,3 +93,42 @@ TEST_CASE("deserializeMsgPack(CustomReader)") {
   REQUIRE(doc[0] == "Hello");
   REQUIRE(doc[1] == "world");
 }
+
+TEST_CASE("deserializeMsgPack(char*)") {
+  StaticJsonDocument<JSON_OBJECT_SIZE(2)> doc;
+
+  SECTION("should store the strings in the input") {
+    char input[] = "\x82\xA5hello\xA5world\xA3key\xD9\x05value";
+
+    DeserializationError err = deserializeMsgPack(doc, input);
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(doc["hello"] == "world");
+    REQUIRE(doc["key"] == "value");
+    const char* world = doc["hello"];
+    REQUIRE(world >= input);
+    REQUIRE(world < input + sizeof(input));
+    REQUIRE(doc.memoryUsage() == JSON_OBJECT_SIZE(2));
+  }
+
+  SECTION("should detect incomplete string") {
+    char input[] = "\x91\xA5hel";
+
+    DeserializationError err = deserializeMsgPack(doc, input, 5);
+
+    REQUIRE(err == DeserializationError::IncompleteInput);
+  }
+}
+
+TEST_CASE("deserializeMsgPack() allocates the exact size of the strings") {
+  std::string value(300, 'x');
+  std::string input = std::string("\x91\xDA\x01\x2C", 4) + value;
+
+  DynamicJsonDocument doc(JSON_ARRAY_SIZE(1) + 301);
+
+  DeserializationError err = deserializeMsgPack(doc, input);
+
+  REQUIRE(err == DeserializationError::Ok);
+  REQUIRE(doc[0] == value);
+  REQUIRE(doc.memoryUsage() == JSON_ARRAY_SIZE(1) + 301);
+}
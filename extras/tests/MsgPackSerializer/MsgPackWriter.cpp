@@ -0,0 +1,133 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <string>
+
+static std::string toMsgPack(const char* json) {
+  DynamicJsonDocument doc(4096);
+  deserializeJson(doc, json);
+  std::string result;
+  serializeMsgPack(doc, result);
+  return result;
+}
+
+TEST_CASE("MsgPackWriter") {
+  std::string output;
+
+  SECTION("Same output as serializeMsgPack()") {
+    {
+      MsgPackWriter<std::string> msgpack(output);
+      REQUIRE(msgpack.beginObject(3));
+      msgpack.key("a");
+      msgpack.beginArray(6);
+      msgpack.value(1);
+      msgpack.value(-300);
+      msgpack.value(70000u);
+      msgpack.value(0.5);
+      msgpack.value(true);
+      msgpack.null();
+      REQUIRE(msgpack.end());
+      msgpack.key(std::string("b"));
+      msgpack.value(std::string("hello"));
+      msgpack.key("c");
+      msgpack.beginObject(1);
+      msgpack.key("d");
+      msgpack.value(static_cast<const char*>(0));
+      msgpack.end();
+      REQUIRE(msgpack.complete() == false);
+      REQUIRE(msgpack.end());
+      REQUIRE(msgpack.complete() == true);
+    }
+    REQUIRE(output ==
+            toMsgPack("{\"a\":[1,-300,70000,0.5,true,null],\"b\":\"hello\","
+                      "\"c\":{\"d\":null}}"));
+  }
+
+  SECTION("Large array header") {
+    {
+      MsgPackWriter<std::string> msgpack(output);
+      msgpack.beginArray(20);
+      for (int i = 0; i < 20; i++) msgpack.value(i);
+      msgpack.end();
+    }
+    REQUIRE(output == toMsgPack("[0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,"
+                                "18,19]"));
+  }
+
+  SECTION("Raw value") {
+    {
+      MsgPackWriter<std::string> msgpack(output);
+      msgpack.beginArray(1);
+      msgpack.value(serialized("\xA1x"));
+      msgpack.end();
+    }
+    REQUIRE(output == "\x91\xA1x");
+  }
+
+  SECTION("Binary and extension") {
+    {
+      MsgPackWriter<std::string> msgpack(output);
+      msgpack.beginArray(2);
+      msgpack.value(MsgPackBinary("\x01\x02", 2));
+      msgpack.value(MsgPackExtension(-1, "\x2A", 1));
+      msgpack.end();
+    }
+    REQUIRE(output == "\x92\xC4\x02\x01\x02\xD4\xFF\x2A");
+  }
+
+  SECTION("Rejects more values than announced") {
+    MsgPackWriter<std::string> msgpack(output);
+    msgpack.beginArray(1);
+    REQUIRE(msgpack.value(1));
+    REQUIRE(msgpack.value(2) == false);
+    REQUIRE(msgpack.beginArray(0) == false);
+  }
+
+  SECTION("Rejects more keys than announced") {
+    MsgPackWriter<std::string> msgpack(output);
+    msgpack.beginObject(1);
+    msgpack.key("a");
+    msgpack.value(1);
+    REQUIRE(msgpack.key("b") == false);
+  }
+
+  SECTION("Rejects end() before the last value") {
+    MsgPackWriter<std::string> msgpack(output);
+    msgpack.beginArray(2);
+    msgpack.value(1);
+    REQUIRE(msgpack.end() == false);
+    msgpack.value(2);
+    REQUIRE(msgpack.end());
+  }
+
+  SECTION("Rejects value without key in object") {
+    MsgPackWriter<std::string> msgpack(output);
+    msgpack.beginObject(1);
+    REQUIRE(msgpack.value(1) == false);
+  }
+
+  SECTION("Rejects counts and sizes that don't fit in 32 bits") {
+    if (sizeof(size_t) > 4) {
+      const size_t huge = size_t(0xFFFFFFFF) + 1;
+      MsgPackWriter<std::string> msgpack(output);
+
+      REQUIRE(msgpack.beginArray(huge) == false);
+      REQUIRE(msgpack.beginObject(huge) == false);
+      REQUIRE(msgpack.value(MsgPackBinary("", huge)) == false);
+      REQUIRE(msgpack.value(MsgPackExtension(1, "", huge)) == false);
+      REQUIRE(msgpack.value(1));  // the root is still expected
+      REQUIRE(msgpack.bytesWritten() == 1);
+    }
+  }
+
+  SECTION("Nesting limit") {
+    MsgPackWriter<std::string> msgpack(output);
+    for (int i = 0; i < ARDUINOJSON_DEFAULT_NESTING_LIMIT; i++)
+      REQUIRE(msgpack.beginArray(1));
+    REQUIRE(msgpack.beginArray(1) == false);
+  }
+}
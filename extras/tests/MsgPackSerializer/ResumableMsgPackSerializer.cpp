@@ -0,0 +1,80 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#include <ArduinoJson.h>
+#include <catch.hpp>
+
+#include <string>
+
+static std::string serializeInChunks(const JsonDocument& doc,
+                                     size_t chunkSize) {
+  ResumableMsgPackSerializer serializer(doc);
+  std::string result;
+  char buffer[64];
+  while (!serializer.done()) {
+    size_t n = serializer.next(buffer, chunkSize);
+    REQUIRE(n <= chunkSize);
+    result.append(buffer, n);
+  }
+  return result;
+}
+
+TEST_CASE("ResumableMsgPackSerializer") {
+  DynamicJsonDocument doc(4096);
+
+  SECTION("Same output as serializeMsgPack() for any chunk size") {
+    deserializeJson(doc,
+                    "{\"hello\":[1,-200,3.5,true,null,\"world\"],\"empty\":{},"
+                    "\"nested\":[[[70000]],{\"k\":\"a longer string that "
+                    "spans several chunks\"}]}");
+    std::string expected;
+    serializeMsgPack(doc, expected);
+
+    for (size_t chunkSize = 1; chunkSize <= 64; chunkSize++) {
+      CAPTURE(chunkSize);
+      REQUIRE(serializeInChunks(doc, chunkSize) == expected);
+    }
+  }
+
+  SECTION("Binary and extension") {
+    doc.add(MsgPackBinary("binary", 6));
+    doc.add(MsgPackExtension(1, "extension", 9));
+    std::string expected;
+    serializeMsgPack(doc, expected);
+
+    for (size_t chunkSize = 1; chunkSize <= 8; chunkSize++) {
+      CAPTURE(chunkSize);
+      REQUIRE(serializeInChunks(doc, chunkSize) == expected);
+    }
+  }
+
+  SECTION("Long strings and binary values") {
+    std::string text(300, 'x');
+    doc[text] = text;
+    doc["bin"] = MsgPackBinary(text.data(), text.size());
+    doc["ext"] = MsgPackExtension(2, text.data(), text.size());
+    std::string expected;
+    serializeMsgPack(doc, expected);
+
+    for (size_t chunkSize = 1; chunkSize <= 64; chunkSize++) {
+      CAPTURE(chunkSize);
+      REQUIRE(serializeInChunks(doc, chunkSize) == expected);
+    }
+  }
+
+  SECTION("Binary at the root") {
+    doc.set(MsgPackBinary("binary", 6));
+
+    REQUIRE(serializeInChunks(doc, 3) == std::string("\xC4\x06", 2) + "binary");
+  }
+
+  SECTION("Done with the last byte") {
+    deserializeJson(doc, "[[1]]");
+    ResumableMsgPackSerializer serializer(doc);
+    char buffer[3];
+
+    REQUIRE(serializer.next(buffer, 3) == 3);
+    REQUIRE(serializer.done());
+  }
+}
@@ -138,4 +138,39 @@ TEST_CASE("serialize MsgPack value") {
     checkVariant(serialized("\xDA\xFF\xFF"), "\xDA\xFF\xFF");
     checkVariant(serialized("\xDB\x00\x01\x00\x00", 5), "\xDB\x00\x01\x00\x00");
   }
+
+  SECTION("bin 8") {
+    checkVariant(MsgPackBinary("", 0), "\xC4\x00", 2);
+    checkVariant(MsgPackBinary("\x01\x02", 2), "\xC4\x02\x01\x02");
+
+    std::string longest(255, '?');
+    checkVariant(MsgPackBinary(longest.data(), longest.size()),
+                 std::string("\xC4\xFF", 2) + longest);
+  }
+
+  SECTION("bin 16") {
+    std::string shortest(256, '?');
+    checkVariant(MsgPackBinary(shortest.data(), shortest.size()),
+                 std::string("\xC5\x01\x00", 3) + shortest);
+  }
+
+  SECTION("fixext") {
+    checkVariant(MsgPackExtension(1, "\x2A", 1), "\xD4\x01\x2A");
+    checkVariant(MsgPackExtension(-1, "\x2A\x2A", 2), "\xD5\xFF\x2A\x2A");
+    checkVariant(MsgPackExtension(1, "1234", 4), "\xD6\x01" "1234");
+    checkVariant(MsgPackExtension(1, "12345678", 8), "\xD7\x01" "12345678");
+    checkVariant(MsgPackExtension(1, "1234567890123456", 16),
+                 "\xD8\x01" "1234567890123456");
+  }
+
+  SECTION("ext 8") {
+    checkVariant(MsgPackExtension(1, "", 0), "\xC7\x00\x01", 3);
+    checkVariant(MsgPackExtension(1, "123", 3), "\xC7\x03\x01" "123");
+  }
+
+  SECTION("ext 16") {
+    std::string shortest(256, '?');
+    checkVariant(MsgPackExtension(1, shortest.data(), shortest.size()),
+                 std::string("\xC8\x01\x00\x01", 4) + shortest);
+  }
 }
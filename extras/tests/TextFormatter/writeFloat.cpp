@@ -16,10 +16,14 @@ using namespace ARDUINOJSON_NAMESPACE;
 template <typename TFloat>
 void check(TFloat input, const std::string& expected) {
   std::string output;
-  Writer<std::string> sb(output);
-  TextFormatter<Writer<std::string> > writer(sb);
-  writer.writeFloat(input);
-  REQUIRE(writer.bytesWritten() == output.size());
+  size_t n;
+  {
+    Writer<std::string> sb(output);
+    TextFormatter<Writer<std::string> > writer(sb);
+    writer.writeFloat(input);
+    n = writer.bytesWritten();
+  }  // flushes the buffer of the writer
+  REQUIRE(n == output.size());
   CHECK(expected == output);
 }
 
@@ -14,6 +14,7 @@ void check(const char* input, std::string expected) {
   StaticStringWriter sb(output, sizeof(output));
   TextFormatter<StaticStringWriter> writer(sb);
   writer.writeString(input);
+  output[writer.bytesWritten()] = '\0';
   REQUIRE(expected == output);
   REQUIRE(writer.bytesWritten() == expected.size());
 }
@@ -54,4 +55,20 @@ TEST_CASE("TextFormatter::writeString()") {
   SECTION("HorizontalTab") {
     check("\t", "\"\\t\"");
   }
+
+  SECTION("Other control characters") {
+    check("\x01", "\"\\u0001\"");
+    check("\x1F", "\"\\u001f\"");
+  }
+
+  SECTION("Delete and UTF-8 are not escaped") {
+    check("\x7F", "\"\x7F\"");
+    check("\xC3\xA9", "\"\xC3\xA9\"");
+  }
+
+  SECTION("Regular characters around escaped ones") {
+    check("hello\nworld", "\"hello\\nworld\"");
+    check("\"quoted\"", "\"\\\"quoted\\\"\"");
+    check("a\tb\\c", "\"a\\tb\\\\c\"");
+  }
 }
@@ -0,0 +1,236 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+// Computes the capacity of the JsonDocument required by each sample file,
+// using the memory pool of this build of the library (the result depends on
+// the platform and on the configuration, pass the same ARDUINOJSON_xxx macros
+// as the target in CMAKE_CXX_FLAGS).
+//
+// Usage: capacity [--msgpack] [--prefix NAME] files...
+//
+// The files are parsed as JSON, except with --msgpack or when their extension
+// is .msgpack or .mpk.
+// The report goes to stderr, and a header with the capacities goes to stdout:
+//
+//   capacity --prefix WEATHER samples/*.json > WeatherCapacity.h
+//   StaticJsonDocument<WEATHER_CAPACITY_MAX> doc;
+
+#define ARDUINOJSON_ENABLE_POOL_STATS 1
+#include <ArduinoJson.h>
+
+#include <ctype.h>   // toupper, isalnum
+#include <stdio.h>   // fopen et al., sprintf
+#include <string.h>  // strcmp, strlen
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using ARDUINOJSON_NAMESPACE::addPadding;
+
+struct Sample {
+  std::string name;
+  size_t capacity;
+};
+
+static bool readFile(const char* path, std::vector<char>& buffer) {
+  FILE* f = fopen(path, "rb");
+  if (!f)
+    return false;
+
+  buffer.clear();
+  char chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0)
+    buffer.insert(buffer.end(), chunk, chunk + n);
+
+  bool ok = !ferror(f);
+  fclose(f);
+  return ok;
+}
+
+static bool endsWith(const std::string& s, const char* suffix) {
+  size_t n = strlen(suffix);
+  return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+static bool isMsgPack(const std::string& path) {
+  return endsWith(path, ".msgpack") || endsWith(path, ".mpk");
+}
+
+static DeserializationError deserialize(JsonDocument& doc,
+                                        const std::vector<char>& input,
+                                        bool msgPack) {
+  const char* data = input.empty() ? "" : &input[0];
+  if (msgPack)
+    return deserializeMsgPack(doc, data, input.size());
+  else
+    return deserializeJson(doc, data, input.size());
+}
+
+// Returns the smallest capacity that can hold the document, or 0 on error
+static size_t measure(const std::vector<char>& input, bool msgPack,
+                      DeserializationError& err) {
+  // find a capacity large enough
+  size_t capacity = 4096;
+  for (;;) {
+    DynamicJsonDocument doc(capacity);
+    if (doc.capacity() < capacity) {
+      err = DeserializationError::NoMemory;
+      return 0;
+    }
+    err = deserialize(doc, input, msgPack);
+    if (err != DeserializationError::NoMemory) {
+      // the peak includes the strings reclaimed during the parsing
+      capacity = addPadding(doc.memoryStats().peakUsage);
+      break;
+    }
+    capacity *= 2;
+  }
+  if (err)
+    return 0;
+
+  // check that the document really fits
+  for (;;) {
+    DynamicJsonDocument doc(capacity);
+    err = deserialize(doc, input, msgPack);
+    if (err != DeserializationError::NoMemory)
+      break;
+    capacity += addPadding(1);
+  }
+  return err ? 0 : capacity;
+}
+
+// Converts a file path to an identifier: "dir/my-file.json" -> "MY_FILE"
+static std::string identifierOf(const std::string& path) {
+  size_t begin = path.find_last_of("/\\");
+  begin = begin == std::string::npos ? 0 : begin + 1;
+  size_t end = path.find_last_of('.');
+  if (end == std::string::npos || end < begin)
+    end = path.size();
+
+  std::string id;
+  if (begin < end && isdigit(static_cast<unsigned char>(path[begin])))
+    id += '_';
+  for (size_t i = begin; i < end; i++) {
+    unsigned char c = static_cast<unsigned char>(path[i]);
+    id += isalnum(c) ? static_cast<char>(toupper(c)) : '_';
+  }
+  return id;
+}
+
+// Appends a number to the identifier if another sample already has it
+static std::string uniqueIdentifier(const std::string& id,
+                                    const std::vector<Sample>& samples) {
+  std::string result = id;
+  for (int n = 2;; n++) {
+    bool taken = false;
+    for (size_t i = 0; i < samples.size(); i++)
+      taken = taken || samples[i].name == result;
+    if (!taken)
+      return result;
+    char suffix[16];
+    sprintf(suffix, "_%d", n);
+    result = id + suffix;
+  }
+}
+
+// Nearest-rank percentile of sorted values
+static size_t percentile(const std::vector<size_t>& sorted, size_t p) {
+  size_t rank = (p * sorted.size() + 99) / 100;
+  return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+static void printHeader(const std::string& prefix,
+                        const std::vector<Sample>& samples,
+                        const std::vector<size_t>& sorted) {
+  using namespace ARDUINOJSON_NAMESPACE;
+  std::cout << "// Generated by ArduinoJson's capacity tool\n"
+            << "// sizeof(void*) = " << sizeof(void*)
+            << ", sizeof(VariantSlot) = " << sizeof(VariantSlot)
+            << ", sizeof(Float) = " << sizeof(Float)
+            << ", sizeof(Integer) = " << sizeof(Integer)
+            << ", ARDUINOJSON_ENABLE_ALIGNMENT = "
+            << ARDUINOJSON_ENABLE_ALIGNMENT << "\n"
+            << "// CAUTION: the capacities are only valid for this platform "
+               "and configuration\n\n"
+            << "#pragma once\n\n"
+            << "#include <stddef.h>\n\n";
+
+  for (size_t i = 0; i < samples.size(); i++)
+    std::cout << "constexpr size_t " << prefix << "_CAPACITY_"
+              << samples[i].name << " = " << samples[i].capacity << ";\n";
+  if (!samples.empty())
+    std::cout << "\n";
+
+  static const size_t percentiles[] = {50, 90, 99};
+  for (size_t i = 0; i < sizeof(percentiles) / sizeof(percentiles[0]); i++)
+    std::cout << "constexpr size_t " << prefix << "_CAPACITY_P"
+              << percentiles[i] << " = " << percentile(sorted, percentiles[i])
+              << ";\n";
+  std::cout << "constexpr size_t " << prefix
+            << "_CAPACITY_MAX = " << sorted.back() << ";\n";
+}
+
+int main(int argc, const char* argv[]) {
+  bool forceMsgPack = false;
+  std::string prefix = "JSON";
+  std::vector<const char*> paths;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--msgpack"))
+      forceMsgPack = true;
+    else if (!strcmp(argv[i], "--prefix") && i + 1 < argc)
+      prefix = argv[++i];
+    else
+      paths.push_back(argv[i]);
+  }
+
+  if (paths.empty()) {
+    std::cerr << "Usage: capacity [--msgpack] [--prefix NAME] files..."
+              << std::endl;
+    return 1;
+  }
+
+  std::vector<Sample> samples;
+  std::vector<size_t> sorted;
+  int status = 0;
+  std::vector<char> input;
+
+  for (size_t i = 0; i < paths.size(); i++) {
+    if (!readFile(paths[i], input)) {
+      std::cerr << paths[i] << ": failed to read" << std::endl;
+      status = 1;
+      continue;
+    }
+
+    DeserializationError err;
+    size_t capacity =
+        measure(input, forceMsgPack || isMsgPack(paths[i]), err);
+    if (err) {
+      std::cerr << paths[i] << ": " << err.c_str() << std::endl;
+      status = 1;
+      continue;
+    }
+
+    std::cerr << paths[i] << ": " << capacity << " bytes" << std::endl;
+    Sample sample;
+    sample.name = uniqueIdentifier(identifierOf(paths[i]), samples);
+    sample.capacity = capacity;
+    samples.push_back(sample);
+    sorted.push_back(capacity);
+  }
+
+  if (sorted.empty())
+    return 1;
+
+  std::sort(sorted.begin(), sorted.end());
+  std::cerr << "p50: " << percentile(sorted, 50)
+            << ", p90: " << percentile(sorted, 90)
+            << ", p99: " << percentile(sorted, 99) << ", max: " << sorted.back()
+            << " (" << sorted.size() << " files)" << std::endl;
+
+  printHeader(prefix, samples, sorted);
+  return status;
+}
@@ -19,6 +19,9 @@
 #include "ArduinoJson/Variant/VariantRef.hpp"
 
 #include "ArduinoJson/Document/DynamicJsonDocument.hpp"
+#include "ArduinoJson/Document/JsonDocumentPool.hpp"
+#include "ArduinoJson/Document/PmrAllocator.hpp"
+#include "ArduinoJson/Document/JsonSnapshot.hpp"
 #include "ArduinoJson/Document/StaticJsonDocument.hpp"
 
 #include "ArduinoJson/Array/ArrayImpl.hpp"
@@ -30,11 +33,17 @@
 #include "ArduinoJson/Variant/VariantAsImpl.hpp"
 #include "ArduinoJson/Variant/VariantImpl.hpp"
 
+#include "ArduinoJson/Cbor/CborDeserializer.hpp"
+#include "ArduinoJson/Cbor/CborSerializer.hpp"
+#include "ArduinoJson/Document/DocumentImage.hpp"
 #include "ArduinoJson/Json/JsonDeserializer.hpp"
 #include "ArduinoJson/Json/JsonSerializer.hpp"
+#include "ArduinoJson/Json/JsonWriter.hpp"
+#include "ArduinoJson/Json/ParallelJsonSerializer.hpp"
 #include "ArduinoJson/Json/PrettyJsonSerializer.hpp"
 #include "ArduinoJson/MsgPack/MsgPackDeserializer.hpp"
 #include "ArduinoJson/MsgPack/MsgPackSerializer.hpp"
+#include "ArduinoJson/MsgPack/MsgPackWriter.hpp"
 
 #include "ArduinoJson/compatibility.hpp"
 
@@ -54,16 +63,49 @@ typedef ARDUINOJSON_NAMESPACE::VariantRef JsonVariant;
 using ARDUINOJSON_NAMESPACE::BasicJsonDocument;
 using ARDUINOJSON_NAMESPACE::copyArray;
 using ARDUINOJSON_NAMESPACE::DeserializationError;
+using ARDUINOJSON_NAMESPACE::deserializeCbor;
 using ARDUINOJSON_NAMESPACE::deserializeJson;
 using ARDUINOJSON_NAMESPACE::deserializeMsgPack;
 using ARDUINOJSON_NAMESPACE::DynamicJsonDocument;
 using ARDUINOJSON_NAMESPACE::JsonDocument;
+using ARDUINOJSON_NAMESPACE::JsonWriter;
+using ARDUINOJSON_NAMESPACE::loadDocumentImage;
+using ARDUINOJSON_NAMESPACE::mapDocumentImage;
+using ARDUINOJSON_NAMESPACE::measureCbor;
+using ARDUINOJSON_NAMESPACE::measureDocumentImage;
 using ARDUINOJSON_NAMESPACE::measureJson;
+using ARDUINOJSON_NAMESPACE::MsgPackBinary;
+using ARDUINOJSON_NAMESPACE::MsgPackExtension;
+using ARDUINOJSON_NAMESPACE::MsgPackWriter;
+using ARDUINOJSON_NAMESPACE::OutputSegment;
+using ARDUINOJSON_NAMESPACE::ResumableJsonSerializer;
+using ARDUINOJSON_NAMESPACE::ResumableMsgPackSerializer;
+using ARDUINOJSON_NAMESPACE::saveDocumentImage;
+using ARDUINOJSON_NAMESPACE::SegmentWriter;
+using ARDUINOJSON_NAMESPACE::serializeCbor;
 using ARDUINOJSON_NAMESPACE::serialized;
 using ARDUINOJSON_NAMESPACE::serializeJson;
 using ARDUINOJSON_NAMESPACE::serializeJsonPretty;
 using ARDUINOJSON_NAMESPACE::serializeMsgPack;
 using ARDUINOJSON_NAMESPACE::StaticJsonDocument;
+#if ARDUINOJSON_ENABLE_POOL_STATS
+using ARDUINOJSON_NAMESPACE::MemoryPoolStats;
+#endif
+#if ARDUINOJSON_ENABLE_STD_ATOMIC
+using ARDUINOJSON_NAMESPACE::BasicJsonSnapshot;
+using ARDUINOJSON_NAMESPACE::JsonSnapshot;
+#endif
+#if ARDUINOJSON_ENABLE_STD_MUTEX
+using ARDUINOJSON_NAMESPACE::BasicJsonDocumentPool;
+using ARDUINOJSON_NAMESPACE::JsonDocumentPool;
+#endif
+#if ARDUINOJSON_ENABLE_STD_THREAD
+using ARDUINOJSON_NAMESPACE::serializeJsonParallel;
+#endif
+#if ARDUINOJSON_ENABLE_STD_PMR
+using ARDUINOJSON_NAMESPACE::PmrAllocator;
+using ARDUINOJSON_NAMESPACE::PmrJsonDocument;
+#endif
 
 namespace DeserializationOption {
 using ARDUINOJSON_NAMESPACE::Filter;
@@ -27,9 +27,9 @@ class VariantPtr {
 
 class ArrayIterator {
  public:
-  ArrayIterator() : _slot(0) {}
+  ArrayIterator() : _slot(0), _prev(0) {}
   explicit ArrayIterator(MemoryPool *pool, VariantSlot *slot)
-      : _pool(pool), _slot(slot) {}
+      : _pool(pool), _slot(slot), _prev(0) {}
 
   VariantRef operator*() const {
     return VariantRef(_pool, _slot->data());
@@ -47,12 +47,15 @@ class ArrayIterator {
   }
 
   ArrayIterator &operator++() {
+    // keep the previous slot if the current one was removed
+    if (!_prev || _prev->next() == _slot)
+      _prev = _slot;
     _slot = _slot->next();
     return *this;
   }
 
   ArrayIterator &operator+=(size_t distance) {
-    _slot = _slot->next(distance);
+    while (distance-- && _slot) operator++();
     return *this;
   }
 
@@ -60,9 +63,15 @@ class ArrayIterator {
     return _slot;
   }
 
+  // The slot before internal(), or null at the beginning
+  VariantSlot *previous() {
+    return _prev;
+  }
+
  private:
   MemoryPool *_pool;
   VariantSlot *_slot;
+  VariantSlot *_prev;
 };
 
 class VariantConstPtr {
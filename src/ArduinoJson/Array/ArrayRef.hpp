@@ -151,7 +151,7 @@ class ArrayRef : public ArrayRefBase<CollectionData>,
   FORCE_INLINE void remove(iterator it) const {
     if (!_data)
       return;
-    _data->removeSlot(it.internal());
+    _data->removeSlot(it.internal(), it.previous());
   }
 
   // Removes element at specified index.
@@ -161,6 +161,14 @@ class ArrayRef : public ArrayRefBase<CollectionData>,
     _data->removeElement(index);
   }
 
+  // Prepares the array to receive n elements.
+  // Only useful with ARDUINOJSON_ENABLE_COLLECTION_INDEX.
+  FORCE_INLINE void reserve(size_t n) const {
+    if (!_data)
+      return;
+    _data->reserve(n, _pool);
+  }
+
  private:
   MemoryPool* _pool;
 };
@@ -0,0 +1,716 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Deserialization/deserialize.hpp>
+#include <ArduinoJson/Memory/MemoryPool.hpp>
+#include <ArduinoJson/MsgPack/endianess.hpp>
+#include <ArduinoJson/MsgPack/ieee754.hpp>
+#include <ArduinoJson/Polyfills/type_traits.hpp>
+#include <ArduinoJson/Variant/VariantData.hpp>
+
+namespace ARDUINOJSON_NAMESPACE {
+
+// Reads CBOR (RFC 8949), with definite and indefinite lengths.
+// The tags are ignored, and the simple values other than false, true, null,
+// and undefined (which becomes null) are not supported.
+template <typename TReader, typename TStringStorage>
+class CborDeserializer {
+  typedef typename remove_reference<TStringStorage>::type::StringBuilder
+      StringBuilder;
+
+ public:
+  CborDeserializer(MemoryPool &pool, TReader reader,
+                   TStringStorage stringStorage)
+      : _pool(&pool), _reader(reader), _stringStorage(stringStorage) {}
+
+  template <typename TFilter>
+  DeserializationError parse(VariantData &variant, TFilter filter,
+                             NestingLimit nestingLimit) {
+    return parseVariant(variant, filter, nestingLimit);
+  }
+
+ private:
+  // Prevent VS warning "assignment operator could not be generated"
+  CborDeserializer &operator=(const CborDeserializer &);
+
+  enum {
+    MAJOR_POSITIVE_INTEGER = 0,
+    MAJOR_NEGATIVE_INTEGER = 1,
+    MAJOR_BYTE_STRING = 2,
+    MAJOR_TEXT_STRING = 3,
+    MAJOR_ARRAY = 4,
+    MAJOR_MAP = 5,
+    MAJOR_TAG = 6,
+    MAJOR_SIMPLE = 7,
+
+    INDEFINITE = 31,  // additional info of indefinite length items
+    BREAK = 0xFF      // ends an indefinite length item
+  };
+
+  static uint8_t majorType(uint8_t code) {
+    return uint8_t(code >> 5);
+  }
+
+  static uint8_t additionalInfo(uint8_t code) {
+    return uint8_t(code & 0x1F);
+  }
+
+  template <typename TFilter>
+  DeserializationError parseVariant(VariantData &variant, TFilter filter,
+                                    NestingLimit nestingLimit) {
+    uint8_t code;
+    if (!readByte(code))
+      return DeserializationError::IncompleteInput;
+    return parseVariant(code, variant, filter, nestingLimit);
+  }
+
+  template <typename TFilter>
+  DeserializationError parseVariant(uint8_t code, VariantData &variant,
+                                    TFilter filter, NestingLimit nestingLimit) {
+    DeserializationError err = skipTags(code);
+    if (err)
+      return err;
+
+    if (!allowed(code, filter))
+      return skipVariant(code, nestingLimit);
+
+    uint8_t info = additionalInfo(code);
+
+    switch (majorType(code)) {
+      case MAJOR_SIMPLE:
+        return readSimpleValue(variant, info);
+
+      case MAJOR_BYTE_STRING:
+        return readBinary(variant, info);
+
+      case MAJOR_TEXT_STRING:
+        return readString(variant, info);
+
+      case MAJOR_ARRAY:
+        if (info == INDEFINITE)
+          return readIndefiniteArray(variant.toArray(), filter, nestingLimit);
+        break;
+
+      case MAJOR_MAP:
+        if (info == INDEFINITE)
+          return readObject(variant.toObject(), 0, true, filter, nestingLimit);
+        break;
+    }
+
+    UInt value;
+    err = readArgument(info, value);
+    if (err)
+      return err;
+
+    switch (majorType(code)) {
+      case MAJOR_POSITIVE_INTEGER:
+        variant.setPositiveInteger(value);
+        return DeserializationError::Ok;
+
+      case MAJOR_NEGATIVE_INTEGER:
+        // -1 - value doesn't fit in Integer
+        if (value + 1 == 0)
+          return DeserializationError::NotSupported;
+        variant.setNegativeInteger(value + 1);
+        return DeserializationError::Ok;
+
+      case MAJOR_ARRAY:
+        return readArray(variant.toArray(), value, filter, nestingLimit);
+
+      default:  // MAJOR_MAP
+        return readObject(variant.toObject(), value, false, filter,
+                          nestingLimit);
+    }
+  }
+
+  template <typename TFilter>
+  static bool allowed(uint8_t code, TFilter filter) {
+    if (majorType(code) == MAJOR_ARRAY)
+      return filter.allowArray();
+    if (majorType(code) == MAJOR_MAP)
+      return filter.allowObject();
+    return filter.allowValue();
+  }
+
+  // Replaces code with the first byte of the tagged value
+  DeserializationError skipTags(uint8_t &code) {
+    while (majorType(code) == MAJOR_TAG) {
+      UInt tag;
+      DeserializationError err = readArgument(additionalInfo(code), tag);
+      if (err)
+        return err;
+      if (!readByte(code))
+        return DeserializationError::IncompleteInput;
+    }
+    return DeserializationError::Ok;
+  }
+
+  // Reads the integer that follows the initial byte, or that is in it
+  DeserializationError readArgument(uint8_t info, UInt &value) {
+    if (info < 24) {
+      value = info;
+      return DeserializationError::Ok;
+    }
+    switch (info) {
+      case 24:
+        return readArgument<uint8_t>(value);
+
+      case 25:
+        return readArgument<uint16_t>(value);
+
+      case 26:
+        return readArgument<uint32_t>(value);
+
+      case 27:
+#if ARDUINOJSON_USE_LONG_LONG
+        return readArgument<uint64_t>(value);
+#else
+        return DeserializationError::NotSupported;
+#endif
+
+      default:  // reserved, or indefinite where it's not allowed
+        return DeserializationError::InvalidInput;
+    }
+  }
+
+  template <typename T>
+  DeserializationError readArgument(UInt &value) {
+    T n;
+    if (!readInteger(n))
+      return DeserializationError::IncompleteInput;
+    value = n;
+    return DeserializationError::Ok;
+  }
+
+  // Reads the length of a string, an array, or a map
+  DeserializationError readLength(uint8_t info, size_t &length) {
+    UInt value;
+    DeserializationError err = readArgument(info, value);
+    if (err)
+      return err;
+    length = static_cast<size_t>(value);
+    if (length != value)  // i.e., larger than the address space
+      return DeserializationError::NoMemory;
+    return DeserializationError::Ok;
+  }
+
+  DeserializationError skipVariant(NestingLimit nestingLimit) {
+    uint8_t code;
+    if (!readByte(code))
+      return DeserializationError::IncompleteInput;
+    return skipVariant(code, nestingLimit);
+  }
+
+  // Skips the value without allocating
+  DeserializationError skipVariant(uint8_t code, NestingLimit nestingLimit) {
+    DeserializationError err = skipTags(code);
+    if (err)
+      return err;
+
+    uint8_t major = majorType(code);
+    uint8_t info = additionalInfo(code);
+
+    if (major == MAJOR_SIMPLE) {
+      switch (info) {
+        case 24:
+          return skipBytes(1);
+        case 25:
+          return skipBytes(2);
+        case 26:
+          return skipBytes(4);
+        case 27:
+          return skipBytes(8);
+        default:
+          return info < 24 ? DeserializationError::Ok
+                           : DeserializationError::InvalidInput;
+      }
+    }
+
+    if (info == INDEFINITE)
+      return skipIndefinite(major, nestingLimit);
+
+    UInt value;
+    err = readArgument(info, value);
+    if (err)
+      return err;
+
+    switch (major) {
+      case MAJOR_BYTE_STRING:
+      case MAJOR_TEXT_STRING:
+        return skipBytes(value);
+
+      case MAJOR_ARRAY:
+        return skipCollection(value, 1, nestingLimit);
+
+      case MAJOR_MAP:
+        return skipCollection(value, 2, nestingLimit);
+
+      default:  // integers
+        return DeserializationError::Ok;
+    }
+  }
+
+  DeserializationError skipIndefinite(uint8_t major,
+                                      NestingLimit nestingLimit) {
+    switch (major) {
+      case MAJOR_BYTE_STRING:
+      case MAJOR_TEXT_STRING:
+        for (;;) {
+          uint8_t code;
+          if (!readByte(code))
+            return DeserializationError::IncompleteInput;
+          if (code == BREAK)
+            return DeserializationError::Ok;
+          if (majorType(code) != major)
+            return DeserializationError::InvalidInput;
+          UInt size;
+          DeserializationError err = readArgument(additionalInfo(code), size);
+          if (err)
+            return err;
+          err = skipBytes(size);
+          if (err)
+            return err;
+        }
+
+      case MAJOR_ARRAY:
+      case MAJOR_MAP:
+        if (nestingLimit.reached())
+          return DeserializationError::TooDeep;
+        for (;;) {
+          uint8_t code;
+          if (!readByte(code))
+            return DeserializationError::IncompleteInput;
+          if (code == BREAK)
+            return DeserializationError::Ok;
+          DeserializationError err =
+              skipVariant(code, nestingLimit.decrement());
+          if (err)
+            return err;
+        }
+
+      default:
+        return DeserializationError::InvalidInput;
+    }
+  }
+
+  DeserializationError skipBytes(UInt n) {
+    for (; n; --n) {
+      if (_reader.read() < 0)
+        return DeserializationError::IncompleteInput;
+    }
+    return DeserializationError::Ok;
+  }
+
+  // Skips n * valuesPerItem values
+  DeserializationError skipCollection(UInt n, uint8_t valuesPerItem,
+                                      NestingLimit nestingLimit) {
+    if (nestingLimit.reached())
+      return DeserializationError::TooDeep;
+
+    for (; n; --n) {
+      for (uint8_t i = 0; i < valuesPerItem; i++) {
+        DeserializationError err = skipVariant(nestingLimit.decrement());
+        if (err)
+          return err;
+      }
+    }
+
+    return DeserializationError::Ok;
+  }
+
+  bool readByte(uint8_t &value) {
+    int c = _reader.read();
+    if (c < 0)
+      return false;
+    value = static_cast<uint8_t>(c);
+    return true;
+  }
+
+  bool readBytes(uint8_t *p, size_t n) {
+    return _reader.readBytes(reinterpret_cast<char *>(p), n) == n;
+  }
+
+  template <typename T>
+  bool readBytes(T &value) {
+    return readBytes(reinterpret_cast<uint8_t *>(&value), sizeof(value));
+  }
+
+  template <typename T>
+  bool readInteger(T &value) {
+    if (!readBytes(value))
+      return false;
+    fixEndianess(value);
+    return true;
+  }
+
+  DeserializationError readSimpleValue(VariantData &variant, uint8_t info) {
+    switch (info) {
+      case 20:
+        variant.setBoolean(false);
+        return DeserializationError::Ok;
+
+      case 21:
+        variant.setBoolean(true);
+        return DeserializationError::Ok;
+
+      case 22:  // null
+      case 23:  // undefined
+        // already null
+        return DeserializationError::Ok;
+
+      case 25:
+        return readHalf(variant);
+
+      case 26:
+        return readFloat<float>(variant);
+
+      case 27:
+        return readDouble<double>(variant);
+
+      case 24:  // simple value in the next byte
+        return DeserializationError::NotSupported;
+
+      default:
+        // the other simple values are unassigned, 28-30 are reserved, and 31
+        // is a break outside of an indefinite length item
+        return info < 20 ? DeserializationError::NotSupported
+                         : DeserializationError::InvalidInput;
+    }
+  }
+
+  DeserializationError readHalf(VariantData &variant) {
+    uint8_t i[2];
+    float value;
+    if (!readBytes(i, 2))
+      return DeserializationError::IncompleteInput;
+    halfToFloat(i, reinterpret_cast<uint8_t *>(&value));
+    fixEndianess(value);
+    variant.setFloat(value);
+    return DeserializationError::Ok;
+  }
+
+  template <typename T>
+  DeserializationError readFloat(VariantData &variant) {
+    T value;
+    if (!readInteger(value))
+      return DeserializationError::IncompleteInput;
+    variant.setFloat(value);
+    return DeserializationError::Ok;
+  }
+
+  template <typename T>
+  typename enable_if<sizeof(T) == 8, DeserializationError>::type readDouble(
+      VariantData &variant) {
+    T value;
+    if (!readInteger(value))
+      return DeserializationError::IncompleteInput;
+    variant.setFloat(value);
+    return DeserializationError::Ok;
+  }
+
+  template <typename T>
+  typename enable_if<sizeof(T) == 4, DeserializationError>::type readDouble(
+      VariantData &variant) {
+    uint8_t i[8];  // input is 8 bytes
+    T value;       // output is 4 bytes
+    uint8_t *o = reinterpret_cast<uint8_t *>(&value);
+    if (!readBytes(i, 8))
+      return DeserializationError::IncompleteInput;
+    doubleToFloat(i, o);
+    fixEndianess(value);
+    variant.setFloat(value);
+    return DeserializationError::Ok;
+  }
+
+  DeserializationError readString(VariantData &variant, uint8_t info) {
+    const char *s = 0;  // <- mute "maybe-uninitialized" (+4 bytes on AVR)
+    size_t n;
+    DeserializationError err = readString(MAJOR_TEXT_STRING, info, s, n);
+    if (err)
+      return err;
+    if (variant.setInlineString(s))
+      _stringStorage.reclaim(s);
+    else
+      variant.setOwnedString(make_not_null(s));
+    return err;
+  }
+
+  // Reads the bytes like a string, so they're followed by a terminator
+  DeserializationError readBinary(VariantData &variant, uint8_t info) {
+    const char *s = 0;  // <- mute "maybe-uninitialized" (+4 bytes on AVR)
+    size_t n = 0;
+    DeserializationError err = readString(MAJOR_BYTE_STRING, info, s, n);
+    if (err)
+      return err;
+    variant.setOwnedBinary(s, n);
+    return err;
+  }
+
+  // Reads a byte string or a text string, of definite or indefinite length
+  DeserializationError readString(uint8_t major, uint8_t info,
+                                  const char *&result, size_t &n) {
+    if (info == INDEFINITE)
+      return readChunks(major, result, n);
+    DeserializationError err = readLength(info, n);
+    if (err)
+      return err;
+    return readString(result, n);
+  }
+
+  // Like in MsgPackDeserializer, the string is allocated at once and read in
+  // a single call.
+  DeserializationError readString(const char *&result, size_t n) {
+    char *s = _stringStorage.allocString(n);
+    if (!s)
+      return DeserializationError::NoMemory;
+    if (!readBytes(reinterpret_cast<uint8_t *>(s), n))
+      return DeserializationError::IncompleteInput;
+    s[n] = 0;
+    result = s;
+    return DeserializationError::Ok;
+  }
+
+  // Concatenates the definite length chunks of an indefinite length string.
+  // With a writable input, the string never grows faster than the input, since
+  // every chunk has a header.
+  DeserializationError readChunks(uint8_t major, const char *&result,
+                                  size_t &n) {
+    StringBuilder builder = _stringStorage.startString();
+    n = 0;
+    for (;;) {
+      uint8_t code;
+      if (!readByte(code))
+        return DeserializationError::IncompleteInput;
+      if (code == BREAK)
+        break;
+      if (majorType(code) != major)
+        return DeserializationError::InvalidInput;
+      UInt size;
+      DeserializationError err = readArgument(additionalInfo(code), size);
+      if (err)
+        return err;
+      for (; size; --size) {
+        uint8_t c;
+        if (!readByte(c))
+          return DeserializationError::IncompleteInput;
+        builder.append(char(c));
+        n++;
+      }
+    }
+    result = builder.complete();
+    if (!result)
+      return DeserializationError::NoMemory;
+    return DeserializationError::Ok;
+  }
+
+  template <typename TFilter>
+  DeserializationError readArray(CollectionData &array, UInt size,
+                                 TFilter filter, NestingLimit nestingLimit) {
+    if (nestingLimit.reached())
+      return DeserializationError::TooDeep;
+
+    TFilter memberFilter = filter[0UL];
+
+    if (!memberFilter.allow())
+      return skipCollection(size, 1, nestingLimit);
+
+    if (size == 0)
+      return DeserializationError::Ok;
+
+    size_t n = static_cast<size_t>(size);
+    if (n != size)
+      return DeserializationError::NoMemory;
+
+    // Like in MsgPackDeserializer, the elements are allocated at once
+    VariantSlot *slot = array.addElements(n, _pool);
+    if (!slot)
+      return DeserializationError::NoMemory;
+
+    for (; slot; slot = slot->next()) {
+      DeserializationError err =
+          parseVariant(*slot->data(), memberFilter, nestingLimit.decrement());
+      if (err)
+        return err;
+    }
+
+    return DeserializationError::Ok;
+  }
+
+  template <typename TFilter>
+  DeserializationError readIndefiniteArray(CollectionData &array,
+                                           TFilter filter,
+                                           NestingLimit nestingLimit) {
+    if (nestingLimit.reached())
+      return DeserializationError::TooDeep;
+
+    TFilter memberFilter = filter[0UL];
+
+    for (;;) {
+      uint8_t code;
+      if (!readByte(code))
+        return DeserializationError::IncompleteInput;
+      if (code == BREAK)
+        return DeserializationError::Ok;
+
+      DeserializationError err;
+      if (memberFilter.allow()) {
+        VariantData *value = array.addElement(_pool);
+        if (!value)
+          return DeserializationError::NoMemory;
+        err = parseVariant(code, *value, memberFilter,
+                           nestingLimit.decrement());
+      } else {
+        err = skipVariant(code, nestingLimit.decrement());
+      }
+      if (err)
+        return err;
+    }
+  }
+
+  // Reads size members, or the members up to the break when indefinite
+  template <typename TFilter>
+  DeserializationError readObject(CollectionData &object, UInt size,
+                                  bool indefinite, TFilter filter,
+                                  NestingLimit nestingLimit) {
+    if (nestingLimit.reached())
+      return DeserializationError::TooDeep;
+
+    for (; indefinite || size; --size) {
+      uint8_t code;
+      if (!readByte(code))
+        return DeserializationError::IncompleteInput;
+      if (indefinite && code == BREAK)
+        return DeserializationError::Ok;
+
+      const char *key = 0;  // <- mute "maybe-uninitialized" (+4 bytes on AVR)
+      DeserializationError err = parseKey(code, key);
+      if (err)
+        return err;
+
+      TFilter memberFilter = filter[key];
+
+      if (memberFilter.allow()) {
+        VariantSlot *slot = object.addSlot(_pool);
+        if (!slot)
+          return DeserializationError::NoMemory;
+
+        slot->setOwnedKey(make_not_null(_pool->internKey(key)));
+        object.indexMember(slot, _pool);
+
+        err = parseVariant(*slot->data(), memberFilter,
+                           nestingLimit.decrement());
+      } else {
+        _stringStorage.reclaim(key);
+        err = skipVariant(nestingLimit.decrement());
+      }
+      if (err)
+        return err;
+    }
+
+    return DeserializationError::Ok;
+  }
+
+  // Only text strings can be keys
+  DeserializationError parseKey(uint8_t code, const char *&key) {
+    if (majorType(code) != MAJOR_TEXT_STRING)
+      return DeserializationError::NotSupported;
+    size_t n;
+    return readString(MAJOR_TEXT_STRING, additionalInfo(code), key, n);
+  }
+
+  MemoryPool *_pool;
+  TReader _reader;
+  TStringStorage _stringStorage;
+};
+
+// deserializeCbor(JsonDocument&, const std::string&, ...)
+template <typename TInput>
+DeserializationError deserializeCbor(
+    JsonDocument &doc, const TInput &input,
+    NestingLimit nestingLimit = NestingLimit()) {
+  return deserialize<CborDeserializer>(doc, input, nestingLimit,
+                                       AllowAllFilter());
+}
+template <typename TInput>
+DeserializationError deserializeCbor(
+    JsonDocument &doc, const TInput &input, Filter filter,
+    NestingLimit nestingLimit = NestingLimit()) {
+  return deserialize<CborDeserializer>(doc, input, nestingLimit, filter);
+}
+template <typename TInput>
+DeserializationError deserializeCbor(JsonDocument &doc, const TInput &input,
+                                     NestingLimit nestingLimit,
+                                     Filter filter) {
+  return deserialize<CborDeserializer>(doc, input, nestingLimit, filter);
+}
+
+// deserializeCbor(JsonDocument&, char*, ...)
+template <typename TInput>
+DeserializationError deserializeCbor(
+    JsonDocument &doc, TInput *input,
+    NestingLimit nestingLimit = NestingLimit()) {
+  return deserialize<CborDeserializer>(doc, input, nestingLimit,
+                                       AllowAllFilter());
+}
+template <typename TInput>
+DeserializationError deserializeCbor(
+    JsonDocument &doc, TInput *input, Filter filter,
+    NestingLimit nestingLimit = NestingLimit()) {
+  return deserialize<CborDeserializer>(doc, input, nestingLimit, filter);
+}
+template <typename TInput>
+DeserializationError deserializeCbor(JsonDocument &doc, TInput *input,
+                                     NestingLimit nestingLimit,
+                                     Filter filter) {
+  return deserialize<CborDeserializer>(doc, input, nestingLimit, filter);
+}
+
+// deserializeCbor(JsonDocument&, char*, size_t, ...)
+template <typename TInput>
+DeserializationError deserializeCbor(
+    JsonDocument &doc, TInput *input, size_t inputSize,
+    NestingLimit nestingLimit = NestingLimit()) {
+  return deserialize<CborDeserializer>(doc, input, inputSize, nestingLimit,
+                                       AllowAllFilter());
+}
+template <typename TInput>
+DeserializationError deserializeCbor(
+    JsonDocument &doc, TInput *input, size_t inputSize, Filter filter,
+    NestingLimit nestingLimit = NestingLimit()) {
+  return deserialize<CborDeserializer>(doc, input, inputSize, nestingLimit,
+                                       filter);
+}
+template <typename TInput>
+DeserializationError deserializeCbor(JsonDocument &doc, TInput *input,
+                                     size_t inputSize,
+                                     NestingLimit nestingLimit,
+                                     Filter filter) {
+  return deserialize<CborDeserializer>(doc, input, inputSize, nestingLimit,
+                                       filter);
+}
+
+// deserializeCbor(JsonDocument&, std::istream&, ...)
+template <typename TInput>
+DeserializationError deserializeCbor(
+    JsonDocument &doc, TInput &input,
+    NestingLimit nestingLimit = NestingLimit()) {
+  return deserialize<CborDeserializer>(doc, input, nestingLimit,
+                                       AllowAllFilter());
+}
+template <typename TInput>
+DeserializationError deserializeCbor(
+    JsonDocument &doc, TInput &input, Filter filter,
+    NestingLimit nestingLimit = NestingLimit()) {
+  return deserialize<CborDeserializer>(doc, input, nestingLimit, filter);
+}
+template <typename TInput>
+DeserializationError deserializeCbor(JsonDocument &doc, TInput &input,
+                                     NestingLimit nestingLimit,
+                                     Filter filter) {
+  return deserialize<CborDeserializer>(doc, input, nestingLimit, filter);
+}
+
+}  // namespace ARDUINOJSON_NAMESPACE
@@ -0,0 +1,174 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/MsgPack/endianess.hpp>
+#include <ArduinoJson/MsgPack/ieee754.hpp>
+#include <ArduinoJson/Polyfills/assert.hpp>
+#include <ArduinoJson/Polyfills/type_traits.hpp>
+#include <ArduinoJson/Serialization/measure.hpp>
+#include <ArduinoJson/Serialization/serialize.hpp>
+#include <ArduinoJson/Variant/VariantData.hpp>
+
+#include <string.h>  // memcpy
+
+namespace ARDUINOJSON_NAMESPACE {
+
+// Writes CBOR (RFC 8949) with definite lengths and the shortest encoding of
+// each value
+template <typename TWriter>
+class CborSerializer {
+ public:
+  CborSerializer(TWriter &writer) : _writer(writer), _bytesWritten(0) {}
+
+  // Uses a half-precision float when the value fits exactly
+  template <typename T>
+  typename enable_if<sizeof(T) == 4>::type visitFloat(T value32) {
+    uint32_t bits;
+    memcpy(&bits, &value32, 4);
+    uint16_t half;
+    if (floatToHalf(bits, half)) {
+      writeByte(0xF9);
+      writeInteger(half);
+    } else {
+      writeByte(0xFA);
+      writeInteger(value32);
+    }
+  }
+
+  template <typename T>
+  ARDUINOJSON_NO_SANITIZE("float-cast-overflow")
+  typename enable_if<sizeof(T) == 8>::type visitFloat(T value64) {
+    float value32 = float(value64);
+    if (value32 == value64 || value64 != value64) {  // exact, or NaN
+      visitFloat(value32);
+    } else {
+      writeByte(0xFB);
+      writeInteger(value64);
+    }
+  }
+
+  void visitArray(const CollectionData& array) {
+    writeHeader(0x80, array.size());
+    for (VariantSlot* slot = array.head(); slot; slot = slot->next()) {
+      slot->data()->accept(*this);
+    }
+  }
+
+  void visitObject(const CollectionData& object) {
+    writeHeader(0xA0, object.size());
+    for (VariantSlot* slot = object.head(); slot; slot = slot->next()) {
+      visitString(slot->key());
+      slot->data()->accept(*this);
+    }
+  }
+
+  void visitString(const char* value) {
+    ARDUINOJSON_ASSERT(value != NULL);
+
+    size_t n = strlen(value);
+    writeHeader(0x60, n);
+    writeBytes(reinterpret_cast<const uint8_t*>(value), n);
+  }
+
+  void visitRawJson(const char* data, size_t size) {
+    writeBytes(reinterpret_cast<const uint8_t*>(data), size);
+  }
+
+  void visitBinary(const char* data, size_t size) {
+    writeHeader(0x40, size);
+    writeBytes(reinterpret_cast<const uint8_t*>(data), size);
+  }
+
+  // CBOR has no equivalent of the MessagePack ext, so it becomes null, like
+  // in JSON
+  void visitExtension(const char*, size_t) {
+    visitNull();
+  }
+
+  // value is the absolute value, CBOR stores -1 - n
+  void visitNegativeInteger(UInt value) {
+    writeHeader(0x20, value - 1);
+  }
+
+  void visitPositiveInteger(UInt value) {
+    writeHeader(0x00, value);
+  }
+
+  void visitBoolean(bool value) {
+    writeByte(value ? 0xF5 : 0xF4);
+  }
+
+  void visitNull() {
+    writeByte(0xF6);
+  }
+
+  size_t bytesWritten() const {
+    return _bytesWritten;
+  }
+
+ private:
+  // Writes the major type, followed by the shortest form of the argument
+  void writeHeader(uint8_t majorType, UInt value) {
+    if (value < 24) {
+      writeByte(uint8_t(majorType + value));
+    } else if (value <= 0xFF) {
+      writeByte(uint8_t(majorType + 24));
+      writeInteger(uint8_t(value));
+    } else if (value <= 0xFFFF) {
+      writeByte(uint8_t(majorType + 25));
+      writeInteger(uint16_t(value));
+    }
+#if ARDUINOJSON_USE_LONG_LONG
+    else if (value <= 0xFFFFFFFF)
+#else
+    else
+#endif
+    {
+      writeByte(uint8_t(majorType + 26));
+      writeInteger(uint32_t(value));
+    }
+#if ARDUINOJSON_USE_LONG_LONG
+    else {
+      writeByte(uint8_t(majorType + 27));
+      writeInteger(uint64_t(value));
+    }
+#endif
+  }
+
+  void writeByte(uint8_t c) {
+    _bytesWritten += _writer.write(c);
+  }
+
+  void writeBytes(const uint8_t* p, size_t n) {
+    _bytesWritten += _writer.write(p, n);
+  }
+
+  template <typename T>
+  void writeInteger(T value) {
+    fixEndianess(value);
+    writeBytes(reinterpret_cast<uint8_t*>(&value), sizeof(value));
+  }
+
+  TWriter &_writer;
+  size_t _bytesWritten;
+};
+
+template <typename TSource, typename TDestination>
+inline size_t serializeCbor(const TSource& source, TDestination& output) {
+  return serialize<CborSerializer>(source, output);
+}
+
+template <typename TSource>
+inline size_t serializeCbor(const TSource& source, void* output, size_t size) {
+  return serialize<CborSerializer>(source, output, size);
+}
+
+template <typename TSource>
+inline size_t measureCbor(const TSource& source) {
+  return measure<CborSerializer>(source);
+}
+
+}  // namespace ARDUINOJSON_NAMESPACE
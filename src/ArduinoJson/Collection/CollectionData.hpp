@@ -11,13 +11,18 @@
 
 namespace ARDUINOJSON_NAMESPACE {
 
+class CollectionIndex;
 class MemoryPool;
 class VariantData;
 class VariantSlot;
+struct PoolRelocation;
 
 class CollectionData {
   VariantSlot *_head;
   VariantSlot *_tail;
+#if ARDUINOJSON_ENABLE_COLLECTION_INDEX
+  CollectionIndex *_index;
+#endif
 
  public:
   // Must be a POD!
@@ -36,6 +41,12 @@ class CollectionData {
 
   void removeElement(size_t index);
 
+  // Prepares the index for n elements
+  void reserve(size_t n, MemoryPool *pool);
+
+  // Appends n null elements in one allocation, and returns the first one
+  VariantSlot *addElements(size_t n, MemoryPool *pool);
+
   bool equalsArray(const CollectionData &other) const;
 
   // Object only
@@ -59,6 +70,9 @@ class CollectionData {
 
   bool equalsObject(const CollectionData &other) const;
 
+  // Must be called when a slot added with addSlot() receives its key
+  void indexMember(VariantSlot *slot, MemoryPool *pool);
+
   // Generic
 
   void clear();
@@ -67,7 +81,21 @@ class CollectionData {
   size_t size() const;
 
   VariantSlot *addSlot(MemoryPool *);
-  void removeSlot(VariantSlot *slot);
+
+  // Appends n linked slots in one allocation, and returns the first one.
+  // CAUTION: for an object, the slots have no key until setOwnedKey().
+  VariantSlot *addSlots(size_t n, MemoryPool *);
+
+  // Removes the slots after last, or all the slots if last is null.
+  // CAUTION: the removed slots must not be in the index.
+  void truncate(VariantSlot *last);
+
+  // Runs in constant time if prev is the slot before, otherwise it has to
+  // look for it.
+  // CAUTION: if the slots around are too far from each other to be linked
+  // (see ARDUINOJSON_SLOT_OFFSET_SIZE), the following values move back one
+  // slot, so the references to them now point to the next value.
+  void removeSlot(VariantSlot *slot, VariantSlot *prev = 0);
 
   bool copyFrom(const CollectionData &src, MemoryPool *pool);
 
@@ -75,7 +103,8 @@ class CollectionData {
     return _head;
   }
 
-  void movePointers(ptrdiff_t stringDistance, ptrdiff_t variantDistance);
+  void movePointers(PoolRelocation &relocation);
+  bool canMovePointers(PoolRelocation &relocation) const;
 
  private:
   VariantSlot *getSlot(size_t index) const;
@@ -84,5 +113,12 @@ class CollectionData {
   VariantSlot *getSlot(TAdaptedString key) const;
 
   VariantSlot *getPreviousSlot(VariantSlot *) const;
+
+  void shiftSlots(VariantSlot *slot);
+
+  void indexElement(VariantSlot *slot, MemoryPool *pool);
+#if ARDUINOJSON_ENABLE_COLLECTION_INDEX
+  void buildElementIndex(size_t capacity, MemoryPool *pool);
+#endif
 };
 }  // namespace ARDUINOJSON_NAMESPACE
@@ -5,11 +5,15 @@
 #pragma once
 
 #include <ArduinoJson/Collection/CollectionData.hpp>
+#include <ArduinoJson/Collection/CollectionIndex.hpp>
 #include <ArduinoJson/Variant/VariantData.hpp>
 
 namespace ARDUINOJSON_NAMESPACE {
 
 inline VariantSlot* CollectionData::addSlot(MemoryPool* pool) {
+  // check before allocating, so that the slot isn't lost
+  if (_tail && !_tail->canLinkTo(pool->nextVariants(1)))
+    return 0;  // see ARDUINOJSON_SLOT_OFFSET_SIZE
   VariantSlot* slot = pool->allocVariant();
   if (!slot)
     return 0;
@@ -26,24 +30,176 @@ inline VariantSlot* CollectionData::addSlot(MemoryPool* pool) {
   return slot;
 }
 
+inline VariantSlot* CollectionData::addSlots(size_t n, MemoryPool* pool) {
+  ARDUINOJSON_ASSERT(n > 0);
+  if (_tail && !_tail->canLinkTo(pool->nextVariants(n)))
+    return 0;  // see ARDUINOJSON_SLOT_OFFSET_SIZE
+  VariantSlot* slots = pool->allocVariants(n);
+  if (!slots)
+    return 0;
+
+  if (_tail) {
+    _tail->setNextNotNull(slots);
+  } else {
+    _head = slots;
+  }
+  _tail = slots + n - 1;
+
+  for (VariantSlot* slot = slots; slot != _tail; slot++) {
+    slot->clear();
+    slot->setNextNotNull(slot + 1);
+  }
+  _tail->clear();
+  return slots;
+}
+
+inline void CollectionData::truncate(VariantSlot* last) {
+  if (last) {
+    last->setNext(0);
+    _tail = last;
+  } else {
+    _head = 0;
+    _tail = 0;
+  }
+}
+
 inline VariantData* CollectionData::addElement(MemoryPool* pool) {
-  return slotData(addSlot(pool));
+  VariantSlot* slot = addSlot(pool);
+  if (!slot)
+    return 0;
+  indexElement(slot, pool);
+  return slot->data();
+}
+
+inline VariantSlot* CollectionData::addElements(size_t n, MemoryPool* pool) {
+  VariantSlot* slots = addSlots(n, pool);
+  if (!slots)
+    return 0;
+#if ARDUINOJSON_ENABLE_COLLECTION_INDEX
+  if (_index) {
+    VariantSlot* slot = slots;
+    while (slot && _index->appendElement(slot)) slot = slot->next();
+    if (slot) {  // the index is full
+      _index = 0;
+      if (!pool->indexFailed(_head))
+        buildElementIndex(0, pool);
+    }
+  } else if (_head->next(ARDUINOJSON_COLLECTION_INDEX_THRESHOLD - 1) &&
+             !pool->indexFailed(_head)) {
+    buildElementIndex(0, pool);
+  }
+#endif
+  return slots;
 }
 
 template <typename TAdaptedString>
 inline VariantData* CollectionData::addMember(TAdaptedString key,
                                               MemoryPool* pool) {
   VariantSlot* slot = addSlot(pool);
+  if (!slot)
+    return 0;
   if (!slotSetKey(slot, key, pool)) {
-    removeSlot(slot);
+    // the slot isn't in the index yet, and removeSlot() would take it for an
+    // element, as it has no key
+    truncate(getPreviousSlot(slot));
     return 0;
   }
+  indexMember(slot, pool);
   return slot->data();
 }
 
+inline void CollectionData::indexMember(VariantSlot* slot, MemoryPool* pool) {
+#if ARDUINOJSON_ENABLE_COLLECTION_INDEX
+  if (_index) {
+    if (_index->insertMember(slot))
+      return;
+  } else if (!_head->next(ARDUINOJSON_COLLECTION_INDEX_THRESHOLD - 1)) {
+    return;  // too small to be worth an index
+  }
+
+  // Build a bigger index; the previous one stays in the pool until it's
+  // cleared or garbage collected
+  _index = 0;
+  if (pool->indexFailed(_head))
+    return;  // don't walk the slots, it won't fit either
+  _index = CollectionIndex::createForMembers(slotSize(_head), pool);
+  if (!_index) {
+    pool->setIndexFailed(_head);
+    return;  // not enough memory, fallback to linear search
+  }
+  // stop at this slot, because the next ones may have no key yet
+  for (VariantSlot* s = _head; s != slot->next(); s = s->next())
+    _index->insertMember(s);
+#else
+  (void)slot;
+  (void)pool;
+#endif
+}
+
+inline void CollectionData::indexElement(VariantSlot* slot, MemoryPool* pool) {
+#if ARDUINOJSON_ENABLE_COLLECTION_INDEX
+  if (_index) {
+    if (_index->appendElement(slot))
+      return;
+  } else if (!_head->next(ARDUINOJSON_COLLECTION_INDEX_THRESHOLD - 1)) {
+    return;  // too small to be worth an index
+  }
+  // the current index, if any, is full
+  _index = 0;
+  if (pool->indexFailed(_head))
+    return;  // don't walk the slots, it won't fit either
+  buildElementIndex(2 * slotSize(_head), pool);
+#else
+  (void)slot;
+  (void)pool;
+#endif
+}
+
+inline void CollectionData::reserve(size_t n, MemoryPool* pool) {
+#if ARDUINOJSON_ENABLE_COLLECTION_INDEX
+  // don't trust the announced size beyond what the pool can hold: each new
+  // element needs a slot and an entry in the index
+  size_t maxElements =
+      (_index ? _index->size() : slotSize(_head)) +
+      pool->available() / (sizeof(VariantSlot) + sizeof(VariantSlot*));
+  if (n > maxElements)
+    n = maxElements;
+  if (n < ARDUINOJSON_COLLECTION_INDEX_THRESHOLD)
+    return;
+  if (_index && _index->capacity() >= n)
+    return;
+  buildElementIndex(n, pool);
+#else
+  (void)n;
+  (void)pool;
+#endif
+}
+
+#if ARDUINOJSON_ENABLE_COLLECTION_INDEX
+// Keeps the current index if the new one doesn't fit
+inline void CollectionData::buildElementIndex(size_t capacity,
+                                              MemoryPool* pool) {
+  size_t count = slotSize(_head);
+  if (capacity < count)
+    capacity = count;
+  CollectionIndex* index = CollectionIndex::createForElements(capacity, pool);
+  if (!index) {
+    pool->setIndexFailed(_head);
+    return;
+  }
+  // the previous index stays in the pool until it's cleared or garbage
+  // collected
+  _index = index;
+  for (VariantSlot* s = _head; s; s = s->next()) _index->appendElement(s);
+}
+#endif
+
 inline void CollectionData::clear() {
   _head = 0;
   _tail = 0;
+#if ARDUINOJSON_ENABLE_COLLECTION_INDEX
+  _index = 0;
+#endif
 }
 
 template <typename TAdaptedString>
@@ -101,6 +257,10 @@ inline bool CollectionData::equalsArray(const CollectionData& other) const {
 
 template <typename TAdaptedString>
 inline VariantSlot* CollectionData::getSlot(TAdaptedString key) const {
+#if ARDUINOJSON_ENABLE_COLLECTION_INDEX
+  if (_index)
+    return _index->findMember(key);
+#endif
   VariantSlot* slot = _head;
   while (slot) {
     if (key.equals(slot->key()))
@@ -111,6 +271,10 @@ inline VariantSlot* CollectionData::getSlot(TAdaptedString key) const {
 }
 
 inline VariantSlot* CollectionData::getSlot(size_t index) const {
+#if ARDUINOJSON_ENABLE_COLLECTION_INDEX
+  if (_index)
+    return _index->getElement(index);
+#endif
   return _head->next(index);
 }
 
@@ -153,25 +317,54 @@ inline VariantData* CollectionData::getElement(size_t index) const {
 
 inline VariantData* CollectionData::getOrAddElement(size_t index,
                                                     MemoryPool* pool) {
-  VariantSlot* slot = _head;
-  while (slot && index > 0) {
-    slot = slot->next();
-    index--;
+  VariantSlot* slot;
+#if ARDUINOJSON_ENABLE_COLLECTION_INDEX
+  if (_index) {
+    slot = _index->getElement(index);
+    if (slot)
+      return slot->data();
+    index -= _index->size();
+  } else
+#endif
+  {
+    slot = _head;
+    while (slot && index > 0) {
+      slot = slot->next();
+      index--;
+    }
   }
   if (!slot)
     index++;
+  VariantData* var = slotData(slot);
   while (index > 0) {
-    slot = addSlot(pool);
+    var = addElement(pool);
     index--;
   }
-  return slotData(slot);
+  return var;
 }
 
-inline void CollectionData::removeSlot(VariantSlot* slot) {
+inline void CollectionData::removeSlot(VariantSlot* slot, VariantSlot* prev) {
   if (!slot)
     return;
-  VariantSlot* prev = getPreviousSlot(slot);
+  // the hint may come from an outdated iterator
+  if (slot == _head)
+    prev = 0;
+  else if (!prev || prev->next() != slot)
+    prev = getPreviousSlot(slot);
   VariantSlot* next = slot->next();
+  if (prev && !prev->canLinkTo(next)) {
+    shiftSlots(slot);  // see ARDUINOJSON_SLOT_OFFSET_SIZE
+    return;
+  }
+#if ARDUINOJSON_ENABLE_COLLECTION_INDEX
+  if (_index) {
+    // array slots have no key
+    if (slot->key())
+      _index->removeMember(slot);
+    else
+      _index->removeElement(slot);
+  }
+#endif
   if (prev)
     prev->setNext(next);
   else
@@ -180,8 +373,49 @@ inline void CollectionData::removeSlot(VariantSlot* slot) {
     _tail = prev;
 }
 
+// Removes the value of the slot by moving the following values one slot back,
+// and unlinking the last slot. The links between the slots don't change, so it
+// works when the neighbours of the slot are too far from each other.
+inline void CollectionData::shiftSlots(VariantSlot* slot) {
+  ARDUINOJSON_ASSERT(slot->next() != 0);
+#if ARDUINOJSON_ENABLE_COLLECTION_INDEX
+  // array slots have no key
+  bool isMember = slot->key() != 0;
+  if (_index && isMember)
+    _index->removeMember(slot);
+#endif
+  VariantSlot* prev = 0;
+  VariantSlot* next = slot->next();
+  while (next) {
+#if ARDUINOJSON_ENABLE_COLLECTION_INDEX
+    if (_index && isMember)
+      _index->removeMember(next);
+#endif
+    slot->copyValueFrom(*next);
+#if ARDUINOJSON_ENABLE_COLLECTION_INDEX
+    if (_index && isMember)
+      _index->insertMember(slot);  // can't fail, we just removed one
+#endif
+    prev = slot;
+    slot = next;
+    next = slot->next();
+  }
+#if ARDUINOJSON_ENABLE_COLLECTION_INDEX
+  if (_index && !isMember)
+    _index->removeElement(slot);
+#endif
+  prev->setNext(0);
+  _tail = prev;
+}
+
 inline void CollectionData::removeElement(size_t index) {
-  removeSlot(getSlot(index));
+  if (index == 0) {
+    removeSlot(_head, 0);
+    return;
+  }
+  VariantSlot* prev = getSlot(index - 1);
+  if (prev)
+    removeSlot(prev->next(), prev);
 }
 
 inline size_t CollectionData::memoryUsage() const {
@@ -191,6 +425,10 @@ inline size_t CollectionData::memoryUsage() const {
     if (s->ownsKey())
       total += strlen(s->key()) + 1;
   }
+#if ARDUINOJSON_ENABLE_COLLECTION_INDEX
+  if (_index)
+    total += _index->memoryUsage();
+#endif
   return total;
 }
 
@@ -205,6 +443,11 @@ inline size_t CollectionData::nesting() const {
 }
 
 inline size_t CollectionData::size() const {
+#if ARDUINOJSON_ENABLE_COLLECTION_INDEX
+  // below the threshold, the walk is short anyway
+  if (_index)
+    return _index->size();
+#endif
   return slotSize(_head);
 }
 
@@ -217,12 +460,126 @@ inline void movePointer(T*& p, ptrdiff_t offset) {
   ARDUINOJSON_ASSERT(isAligned(p));
 }
 
-inline void CollectionData::movePointers(ptrdiff_t stringDistance,
-                                         ptrdiff_t variantDistance) {
-  movePointer(_head, variantDistance);
-  movePointer(_tail, variantDistance);
+inline void CollectionData::movePointers(PoolRelocation& relocation) {
+  movePointer(_head, relocation.variantDistance);
+  movePointer(_tail, relocation.variantDistance);
+#if ARDUINOJSON_ENABLE_COLLECTION_INDEX
+  movePointer(_index, relocation.variantDistance);
+  if (_index)
+    _index->movePointers(relocation.variantDistance);
+#endif
   for (VariantSlot* slot = _head; slot; slot = slot->next())
-    slot->movePointers(stringDistance, variantDistance);
+    slot->movePointers(relocation);
+}
+
+// The slots are already at their new address, and they can be reached from
+// there, because they are linked with relative offsets; only the pointers to
+// the slots still have their old value.
+// Each link is checked before it's followed.
+inline bool CollectionData::canMovePointers(PoolRelocation& relocation) const {
+  const VariantSlot* head = 0;
+  const VariantSlot* last = 0;
+  size_t count = 0;
+  if (_head) {
+    head = relocation.movedVariant(_head);
+    if (!head)
+      return false;
+    const VariantSlot* slot = head;
+    for (;;) {
+      if (relocation.remainingSlots == 0)
+        return false;  // the links form a loop
+      relocation.remainingSlots--;
+      if (!slot->canMovePointers(relocation))
+        return false;
+      last = slot;
+      count++;
+      uintptr_t next = slot->nextAddress();
+      if (!next)
+        break;
+      slot = relocation.checkVariant<VariantSlot>(next);
+      if (!slot)
+        return false;
+    }
+  }
+  if (_tail ? relocation.movedVariant(_tail) != last : last != 0)
+    return false;
+#if ARDUINOJSON_ENABLE_COLLECTION_INDEX
+  if (_index) {
+    const CollectionIndex* index = relocation.movedVariant(_index);
+    if (!index || !index->canMovePointers(relocation, head, count))
+      return false;
+  }
+#endif
+  return true;
+}
+
+inline bool VariantSlot::canMovePointers(PoolRelocation& relocation) const {
+  if (_flags & KEY_IS_OWNED) {
+    if (!relocation.isValidString(_key))
+      return false;
+  } else if (_key) {
+    return false;  // linked strings never move
+  }
+  return data()->canMovePointers(relocation);
+}
+
+#if ARDUINOJSON_ENABLE_COLLECTION_INDEX
+inline void CollectionIndex::movePointers(ptrdiff_t variantDistance) {
+  for (size_t i = 0; i < _capacity; i++)
+    movePointer(entries()[i], variantDistance);
+}
+
+inline bool CollectionIndex::canMovePointers(const PoolRelocation& relocation,
+                                             const VariantSlot* head,
+                                             size_t count) const {
+  uintptr_t entriesAddress = reinterpret_cast<uintptr_t>(entries());
+  if (entriesAddress > relocation.newVariantsEnd ||
+      _capacity > (relocation.newVariantsEnd - entriesAddress) /
+                      sizeof(VariantSlot*))
+    return false;
+  if (_count != count || _count > _capacity)
+    return false;
+  if (!head)
+    return true;
+
+  if (!head->key()) {
+    // an array
+    size_t i = 0;
+    for (const VariantSlot* s = head; s; s = s->next(), i++) {
+      if (!entries()[i] || relocation.movedVariant(entries()[i]) != s)
+        return false;
+    }
+    return true;
+  }
+
+  // an object: the hash table must have room for an empty entry, and hold
+  // every member, and nothing else
+  if ((_capacity & (_capacity - 1)) != 0 || 2 * _count > _capacity)
+    return false;
+  size_t entryCount = 0;
+  for (size_t i = 0; i < _capacity; i++) {
+    if (!entries()[i])
+      continue;
+    if (!relocation.movedVariant(entries()[i]))
+      return false;
+    entryCount++;
+  }
+  if (entryCount != _count)
+    return false;
+  for (const VariantSlot* s = head; s; s = s->next()) {
+    if (!s->key())
+      return false;
+    size_t i = hashString(relocation.movedString(s->key())) & mask();
+    for (;;) {
+      if (!entries()[i])
+        return false;
+      if (relocation.movedVariant(entries()[i]) == s)
+        break;
+      i = (i + 1) & mask();
+    }
+  }
+  return true;
 }
+#endif
 
 }  // namespace ARDUINOJSON_NAMESPACE
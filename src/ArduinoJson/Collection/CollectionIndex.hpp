@@ -0,0 +1,184 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Memory/MemoryPool.hpp>
+#include <ArduinoJson/Strings/StringHasher.hpp>
+
+#include <string.h>  // memmove, memset
+
+namespace ARDUINOJSON_NAMESPACE {
+
+// Index of the slots of a large collection.
+// For an object, it's a hash table mapping the keys to the slots, using open
+// addressing with linear probing.
+// For an array, it's the list of the slots in order.
+// In both cases, the entries are stored right after the header, in the
+// variant area of the memory pool.
+class CollectionIndex {
+ public:
+  // Must be a POD!
+  // - no constructor
+  // - no destructor
+  // - no virtual
+  // - no inheritance
+
+  // Allocates an empty hash table that can hold at least `count` members
+  static CollectionIndex* createForMembers(size_t count, MemoryPool* pool) {
+    size_t capacity = 1;
+    while (capacity < 2 * count) capacity *= 2;
+    return create(capacity, pool);
+  }
+
+  // Allocates an empty list that can hold `capacity` elements
+  static CollectionIndex* createForElements(size_t capacity,
+                                            MemoryPool* pool) {
+    return create(capacity, pool);
+  }
+
+  // Object only
+
+  // Returns false if the index is too full to accept another entry
+  bool insertMember(VariantSlot* slot) {
+    if (!slot->key())
+      return true;
+    if (2 * (_count + 1) > _capacity)
+      return false;
+    size_t i = hashString(slot->key()) & mask();
+    while (entries()[i]) i = (i + 1) & mask();
+    entries()[i] = slot;
+    _count++;
+    return true;
+  }
+
+  // Returns the first slot inserted with this key, like a linear search would
+  template <typename TAdaptedString>
+  VariantSlot* findMember(const TAdaptedString& key) const {
+    if (key.isNull())
+      return 0;
+    size_t i = hashAdaptedString(key) & mask();
+    for (;;) {
+      // the table is never full, so this loop ends on an empty entry
+      VariantSlot* slot = entries()[i];
+      if (!slot || key.equals(slot->key()))
+        return slot;
+      i = (i + 1) & mask();
+    }
+  }
+
+  void removeMember(VariantSlot* slot) {
+    if (!slot->key())
+      return;
+    size_t i = hashString(slot->key()) & mask();
+    while (entries()[i] != slot) {
+      if (!entries()[i])
+        return;
+      i = (i + 1) & mask();
+    }
+
+    // Shift back the following entries to fill the hole, so that lookups
+    // don't need tombstones
+    size_t hole = i;
+    for (;;) {
+      i = (i + 1) & mask();
+      VariantSlot* next = entries()[i];
+      if (!next)
+        break;
+      size_t home = hashString(next->key()) & mask();
+      if (((i - home) & mask()) >= ((i - hole) & mask())) {
+        entries()[hole] = next;
+        hole = i;
+      }
+    }
+    entries()[hole] = 0;
+    _count--;
+  }
+
+  // Array only
+
+  // Returns false if the index is full
+  bool appendElement(VariantSlot* slot) {
+    if (_count >= _capacity)
+      return false;
+    entries()[_count++] = slot;
+    return true;
+  }
+
+  VariantSlot* getElement(size_t index) const {
+    return index < _count ? entries()[index] : 0;
+  }
+
+  // Shifts the following entries back, so that the list stays compact.
+  // It moves pointers, but it doesn't walk the slots.
+  void removeElement(VariantSlot* slot) {
+    ARDUINOJSON_ASSERT(_count > 0);
+    size_t i = _count - 1;
+    if (entries()[i] != slot) {
+      for (i = 0; i < _count && entries()[i] != slot; i++) {
+      }
+      if (i == _count)
+        return;
+      memmove(entries() + i, entries() + i + 1,
+              (_count - i - 1) * sizeof(VariantSlot*));
+    }
+    _count--;
+    entries()[_count] = 0;
+  }
+
+  // Generic
+
+  size_t capacity() const {
+    return _capacity;
+  }
+
+  size_t size() const {
+    return _count;
+  }
+
+  size_t memoryUsage() const {
+    return MemoryPool::variantBlockSize(sizeFor(_capacity));
+  }
+
+  void movePointers(ptrdiff_t variantDistance);
+
+  // Tells if the entries are the count slots that start at head (see
+  // CollectionData::canMovePointers())
+  bool canMovePointers(const PoolRelocation& relocation,
+                       const VariantSlot* head, size_t count) const;
+
+ private:
+  static CollectionIndex* create(size_t capacity, MemoryPool* pool) {
+    CollectionIndex* index = reinterpret_cast<CollectionIndex*>(
+        pool->allocIndexBlock(sizeFor(capacity)));
+    if (!index)
+      return 0;
+    index->_capacity = capacity;
+    index->_count = 0;
+    memset(index->entries(), 0, capacity * sizeof(VariantSlot*));
+    return index;
+  }
+
+  static size_t sizeFor(size_t capacity) {
+    return sizeof(CollectionIndex) + capacity * sizeof(VariantSlot*);
+  }
+
+  // Object only: the capacity is a power of 2
+  size_t mask() const {
+    return _capacity - 1;
+  }
+
+  VariantSlot** entries() {
+    return reinterpret_cast<VariantSlot**>(this + 1);
+  }
+
+  VariantSlot* const* entries() const {
+    return reinterpret_cast<VariantSlot* const*>(this + 1);
+  }
+
+  size_t _capacity;
+  size_t _count;
+};
+
+}  // namespace ARDUINOJSON_NAMESPACE
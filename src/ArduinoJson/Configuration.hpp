@@ -56,6 +56,66 @@
 #endif
 #endif
 
+// Auto enable JsonSnapshot if std::atomic is available, except on embedded
+// targets
+#if !defined(ARDUINOJSON_ENABLE_STD_ATOMIC)
+#if !ARDUINOJSON_EMBEDDED_MODE && ARDUINOJSON_HAS_RVALUE_REFERENCES && \
+    defined(__has_include)
+#if __has_include(<atomic>)
+#define ARDUINOJSON_ENABLE_STD_ATOMIC 1
+#else
+#define ARDUINOJSON_ENABLE_STD_ATOMIC 0
+#endif
+#else
+#define ARDUINOJSON_ENABLE_STD_ATOMIC 0
+#endif
+#endif
+
+// Auto enable JsonDocumentPool if std::mutex is available, except on embedded
+// targets, where <mutex> may exist without a usable std::mutex
+#if !defined(ARDUINOJSON_ENABLE_STD_MUTEX)
+#if !ARDUINOJSON_EMBEDDED_MODE && ARDUINOJSON_HAS_RVALUE_REFERENCES && \
+    defined(__has_include)
+#if __has_include(<mutex>)
+#define ARDUINOJSON_ENABLE_STD_MUTEX 1
+#else
+#define ARDUINOJSON_ENABLE_STD_MUTEX 0
+#endif
+#else
+#define ARDUINOJSON_ENABLE_STD_MUTEX 0
+#endif
+#endif
+
+// Auto enable serializeJsonParallel() if std::thread is available, except on
+// embedded targets
+#if !defined(ARDUINOJSON_ENABLE_STD_THREAD)
+#if !ARDUINOJSON_EMBEDDED_MODE && ARDUINOJSON_HAS_RVALUE_REFERENCES && \
+    defined(__has_include)
+#if __has_include(<thread>)
+#define ARDUINOJSON_ENABLE_STD_THREAD 1
+#else
+#define ARDUINOJSON_ENABLE_STD_THREAD 0
+#endif
+#else
+#define ARDUINOJSON_ENABLE_STD_THREAD 0
+#endif
+#endif
+
+// Auto enable PmrAllocator if std::pmr is available (C++17)
+#if !defined(ARDUINOJSON_ENABLE_STD_PMR)
+#if (__cplusplus >= 201703L ||                                \
+     (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)) &&       \
+    defined(__has_include)
+#if __has_include(<memory_resource>)
+#define ARDUINOJSON_ENABLE_STD_PMR 1
+#else
+#define ARDUINOJSON_ENABLE_STD_PMR 0
+#endif
+#else
+#define ARDUINOJSON_ENABLE_STD_PMR 0
+#endif
+#endif
+
 #if ARDUINOJSON_EMBEDDED_MODE
 
 // Store floats by default to reduce the memory usage (issue #134)
@@ -211,6 +271,47 @@
 #endif
 #endif
 
+// Store a single copy of identical keys in the memory pool
+#ifndef ARDUINOJSON_ENABLE_KEY_INTERNING
+#define ARDUINOJSON_ENABLE_KEY_INTERNING 0
+#endif
+
+// Number of distinct keys that can be interned in a document
+// CAUTION: must be a power of 2
+#ifndef ARDUINOJSON_KEY_INTERNING_TABLE_SIZE
+#define ARDUINOJSON_KEY_INTERNING_TABLE_SIZE 32
+#endif
+
+// Index large arrays and objects to speed up lookups
+#ifndef ARDUINOJSON_ENABLE_COLLECTION_INDEX
+#define ARDUINOJSON_ENABLE_COLLECTION_INDEX 0
+#endif
+
+// Number of elements from which a collection gets an index
+#ifndef ARDUINOJSON_COLLECTION_INDEX_THRESHOLD
+#define ARDUINOJSON_COLLECTION_INDEX_THRESHOLD 16
+#endif
+
+// Number of bytes used to link a slot to its next sibling (1, 2 or 4).
+// Increase it if the members of a collection can be more than 127 (1 byte) or
+// 32767 (2 bytes) slots apart, for example with very large nested documents.
+// 0 means 1 on 8-bit platforms, 4 on 64-bit hosts (where it fits in the
+// padding of the slot), and 2 otherwise.
+#ifndef ARDUINOJSON_SLOT_OFFSET_SIZE
+#define ARDUINOJSON_SLOT_OFFSET_SIZE 0
+#endif
+
+// Store short strings inside the variant instead of the memory pool.
+// CAUTION: a pointer to such a string is only valid until the variant changes
+#ifndef ARDUINOJSON_ENABLE_INLINE_STRINGS
+#define ARDUINOJSON_ENABLE_INLINE_STRINGS 0
+#endif
+
+// Collect statistics about the memory pool, see JsonDocument::memoryStats()
+#ifndef ARDUINOJSON_ENABLE_POOL_STATS
+#define ARDUINOJSON_ENABLE_POOL_STATS 0
+#endif
+
 #ifndef ARDUINOJSON_TAB
 #define ARDUINOJSON_TAB "  "
 #endif
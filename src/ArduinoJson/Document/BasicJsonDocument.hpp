@@ -108,19 +108,32 @@ class BasicJsonDocument : AllocatorOwner<TAllocator>, public JsonDocument {
     if (bytes_reclaimed == 0)
       return;
 
+    // the old buffer is freed by reallocate(), only its address remains
     void* old_ptr = _pool.buffer();
+    uintptr_t old_address = reinterpret_cast<uintptr_t>(old_ptr);
+
+    PoolRelocation relocation;
+    relocation.oldStringsBegin = old_address;
+    relocation.oldStringsEnd = old_address + _pool.capacity();
+
     void* new_ptr = this->reallocate(old_ptr, _pool.capacity());
 
-    ptrdiff_t ptr_offset =
-        static_cast<char*>(new_ptr) - static_cast<char*>(old_ptr);
+    ptrdiff_t ptr_offset = static_cast<ptrdiff_t>(
+        reinterpret_cast<uintptr_t>(new_ptr) - old_address);
+
+    relocation.stringDistance = ptr_offset;
+    relocation.variantDistance = ptr_offset - bytes_reclaimed;
+    relocation.skippedStrings = false;
+    relocation.linkedStrings = false;
 
     _pool.movePointers(ptr_offset);
-    _data.movePointers(ptr_offset, ptr_offset - bytes_reclaimed);
+    _data.movePointers(relocation);
   }
 
   bool garbageCollect() {
-    // make a temporary clone and move assign
-    BasicJsonDocument tmp(*this);
+    // make a temporary deep copy and move assign
+    // (the copy-constructor would keep the garbage)
+    BasicJsonDocument tmp(capacity(), allocator());
     if (!tmp.capacity())
       return false;
     tmp.set(*this);
@@ -149,7 +162,7 @@ class BasicJsonDocument : AllocatorOwner<TAllocator>, public JsonDocument {
 
   void copyAssignFrom(const JsonDocument& src) {
     reallocPoolIfTooSmall(src.capacity());
-    set(src);
+    cloneFrom(src);
   }
 
   void moveAssignFrom(BasicJsonDocument& src) {
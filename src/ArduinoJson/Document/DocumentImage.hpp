@@ -0,0 +1,260 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Deserialization/DeserializationError.hpp>
+#include <ArduinoJson/Document/JsonDocument.hpp>
+#include <ArduinoJson/Memory/Alignment.hpp>
+#include <ArduinoJson/Memory/PoolRelocation.hpp>
+
+#include <stddef.h>  // offsetof
+#include <stdint.h>  // uint8_t, uint16_t, uint64_t, uintptr_t
+#include <string.h>  // memcmp, memcpy, memset
+
+namespace ARDUINOJSON_NAMESPACE {
+
+// A document image is a copy of the memory pool of a JsonDocument that can be
+// loaded back without parsing: the loader only has to relocate the pointers.
+//
+// +--------+------+---------+---------+----------+
+// | header | root | strings | padding | variants |
+// +--------+------+---------+---------+----------+
+//
+// An image can only be loaded by a program with the same pointer size,
+// endianness, and layout-changing configuration; the header allows to check
+// that.
+// CAUTION: the image must be aligned like a pointer. The loaders check that
+// every link and every pointer remains in the image, so a corrupted image is
+// rejected, but they don't validate the content of the strings.
+// The old address of the pool is only used as a number: it may not be valid
+// in this program.
+struct DocumentImageHeader {
+  char magic[4];
+  uint16_t byteOrder;
+  uint8_t version;
+  uint8_t pointerSize;
+  uint8_t floatSize;
+  uint8_t integerSize;
+  uint8_t slotOffsetSize;
+  uint8_t features;
+  uint16_t slotSize;
+  uint16_t headerSize;
+  uint64_t base;  // address of the strings when the image was saved
+  uint64_t stringsSize;
+  uint64_t variantsSize;
+
+  enum {
+    FEATURE_COLLECTION_INDEX = 0x01,
+    FEATURE_INLINE_STRINGS = 0x02
+  };
+
+  static DocumentImageHeader forThisProgram() {
+    DocumentImageHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, "AJDI", 4);
+    h.byteOrder = 0x0102;
+    h.version = 1;
+    h.pointerSize = sizeof(void *);
+    h.floatSize = sizeof(Float);
+    h.integerSize = sizeof(UInt);
+    h.slotOffsetSize = sizeof(VariantSlotDiff);
+    h.features = 0;
+#if ARDUINOJSON_ENABLE_COLLECTION_INDEX
+    h.features |= FEATURE_COLLECTION_INDEX;
+#endif
+#if ARDUINOJSON_ENABLE_INLINE_STRINGS
+    h.features |= FEATURE_INLINE_STRINGS;
+#endif
+    h.slotSize = sizeof(VariantSlot);
+    h.headerSize = sizeof(DocumentImageHeader);
+    return h;
+  }
+
+  // Tells if this program can load an image with this header
+  bool isCompatible() const {
+    DocumentImageHeader expected = forThisProgram();
+    // compare every field before "base"
+    return !memcmp(this, &expected, offsetof(DocumentImageHeader, base));
+  }
+
+  static size_t rootOffset() {
+    return addPadding(sizeof(DocumentImageHeader));
+  }
+
+  static size_t poolOffset() {
+    return rootOffset() + addPadding(sizeof(VariantData));
+  }
+
+  size_t poolSize() const {
+    return addPadding(size_t(stringsSize)) + size_t(variantsSize);
+  }
+
+  size_t imageSize() const {
+    return poolOffset() + poolSize();
+  }
+
+  // Tells how the pointers move when the strings are at newStrings
+  // and the variants at newVariants
+  PoolRelocation relocationTo(const char *newStrings,
+                              const char *newVariants) const {
+    uintptr_t oldStrings = static_cast<uintptr_t>(base);
+    uintptr_t oldVariants = oldStrings + addPadding(size_t(stringsSize));
+    uintptr_t strings = reinterpret_cast<uintptr_t>(newStrings);
+    uintptr_t variants = reinterpret_cast<uintptr_t>(newVariants);
+
+    PoolRelocation relocation;
+    relocation.oldStringsBegin = oldStrings;
+    relocation.oldStringsEnd = oldStrings + size_t(stringsSize);
+    relocation.stringDistance = static_cast<ptrdiff_t>(strings - oldStrings);
+    relocation.variantDistance = static_cast<ptrdiff_t>(variants - oldVariants);
+    relocation.skippedStrings = false;
+    relocation.linkedStrings = false;
+
+    relocation.newVariantsBegin = variants;
+    relocation.newVariantsEnd = variants + size_t(variantsSize);
+    // the last string ends with the last terminator
+    size_t terminated = size_t(stringsSize);
+    while (terminated > 0 && newStrings[terminated - 1] != 0) terminated--;
+    relocation.newStringsLimit = strings + terminated;
+    relocation.remainingSlots = size_t(variantsSize) / sizeof(VariantSlot);
+    return relocation;
+  }
+
+  // Reads the header and checks that the image is complete
+  static bool read(DocumentImageHeader &header, const void *image,
+                   size_t imageSize) {
+    if (!image || imageSize < poolOffset() || !isAligned(image))
+      return false;
+    memcpy(&header, image, sizeof(header));
+    if (!header.isCompatible())
+      return false;
+    if (header.stringsSize > imageSize || header.variantsSize > imageSize)
+      return false;  // don't overflow in imageSize()
+    if (!isAligned(size_t(header.variantsSize)))
+      return false;
+    return header.imageSize() <= imageSize;
+  }
+};
+
+// Returns the size of the image of the document
+inline size_t measureDocumentImage(const JsonDocument &doc) {
+  DocumentImageHeader header = DocumentImageHeader::forThisProgram();
+  header.stringsSize = doc.memoryPool().stringsSize();
+  header.variantsSize = doc.memoryPool().variantsSize();
+  return header.imageSize();
+}
+
+// Writes the image of the document in the buffer.
+// Returns the number of bytes written, or 0 if the buffer is too small or
+// unaligned, or if the document contains linked strings (they're not in the
+// pool, so they can't be saved).
+inline size_t saveDocumentImage(const JsonDocument &doc, void *output,
+                                size_t outputSize) {
+  if (!output || !isAligned(output))
+    return 0;
+
+  const MemoryPool &pool = doc.memoryPool();
+  DocumentImageHeader header = DocumentImageHeader::forThisProgram();
+  header.stringsSize = pool.stringsSize();
+  header.variantsSize = pool.variantsSize();
+  if (header.imageSize() > outputSize)
+    return 0;
+
+  char *image = static_cast<char *>(output);
+  MemoryPool imagePool(image + header.poolOffset(), header.poolSize());
+  PoolRelocation relocation;
+  if (!imagePool.cloneFrom(pool, relocation))
+    return 0;
+
+  VariantData *root =
+      reinterpret_cast<VariantData *>(image + header.rootOffset());
+  *root = doc.data();
+  root->movePointers(relocation);
+  if (relocation.skippedStrings || relocation.linkedStrings)
+    return 0;
+
+  header.base = reinterpret_cast<uintptr_t>(imagePool.buffer());
+  memcpy(image, &header, sizeof(header));
+  return header.imageSize();
+}
+
+// Copies the image in the memory pool of the document and relocates the
+// pointers.
+inline DeserializationError loadDocumentImage(JsonDocument &doc,
+                                              const void *input,
+                                              size_t inputSize) {
+  doc.clear();
+
+  DocumentImageHeader header;
+  if (!DocumentImageHeader::read(header, input, inputSize))
+    return DeserializationError::InvalidInput;
+
+  MemoryPool &pool = doc.memoryPool();
+  size_t stringsSize = size_t(header.stringsSize);
+  size_t variantsSize = size_t(header.variantsSize);
+  if (stringsSize + variantsSize > pool.capacity())
+    return DeserializationError::NoMemory;
+
+  const char *image = static_cast<const char *>(input);
+  const char *imageStrings = image + header.poolOffset();
+  const char *imageVariants = imageStrings + addPadding(stringsSize);
+  // can't fail: the pool is empty and large enough
+  char *strings = pool.allocFrozenString(stringsSize);
+  char *variants = static_cast<char *>(pool.allocRight(variantsSize));
+  if (stringsSize)
+    memcpy(strings, imageStrings, stringsSize);
+  if (variantsSize)
+    memcpy(variants, imageVariants, variantsSize);
+
+  PoolRelocation relocation = header.relocationTo(strings, variants);
+  memcpy(&doc.data(), image + header.rootOffset(), sizeof(VariantData));
+  if (!doc.data().canMovePointers(relocation)) {
+    doc.clear();
+    return DeserializationError::InvalidInput;
+  }
+  doc.data().movePointers(relocation);
+  if (relocation.skippedStrings || relocation.linkedStrings) {
+    doc.clear();
+    return DeserializationError::InvalidInput;
+  }
+  return DeserializationError::Ok;
+}
+
+// Relocates the pointers of the image where it is, for example in a private
+// (copy-on-write) memory mapping of a file, and returns its root.
+// The image remains usable after that, and can be mapped again at another
+// address.
+inline DeserializationError mapDocumentImage(void *image, size_t imageSize,
+                                             VariantConstRef &root) {
+  root = VariantConstRef(0);
+
+  DocumentImageHeader header;
+  if (!DocumentImageHeader::read(header, image, imageSize))
+    return DeserializationError::InvalidInput;
+
+  char *bytes = static_cast<char *>(image);
+  char *strings = bytes + header.poolOffset();
+  char *variants = strings + addPadding(size_t(header.stringsSize));
+  VariantData *data =
+      reinterpret_cast<VariantData *>(bytes + header.rootOffset());
+
+  // check before changing anything, so that a corrupt image isn't mistaken
+  // for a relocated one by the next call
+  PoolRelocation relocation = header.relocationTo(strings, variants);
+  if (!data->canMovePointers(relocation))
+    return DeserializationError::InvalidInput;
+
+  // nothing to move if the image is where it was saved or last mapped
+  if (header.base != reinterpret_cast<uintptr_t>(strings)) {
+    data->movePointers(relocation);
+
+    header.base = reinterpret_cast<uintptr_t>(strings);
+    memcpy(image, &header, sizeof(header));
+  }
+  root = VariantConstRef(data);
+  return DeserializationError::Ok;
+}
+
+}  // namespace ARDUINOJSON_NAMESPACE
@@ -48,6 +48,20 @@ class JsonDocument : public Visitable {
     return _pool.size();
   }
 
+#if ARDUINOJSON_ENABLE_POOL_STATS
+  const MemoryPoolStats& memoryStats() const {
+    return _pool.stats();
+  }
+
+  // Restarts the statistics that accumulate across clear()
+  void resetMemoryStats() {
+    MemoryPoolStats& stats = _pool.stats();
+    stats.peakUsage = _pool.size();
+    stats.failedAllocations = 0;
+    stats.reclaimedBytes = 0;
+  }
+#endif
+
   size_t nesting() const {
     return _data.nesting();
   }
@@ -81,10 +95,18 @@ class JsonDocument : public Visitable {
     return _pool;
   }
 
+  const MemoryPool& memoryPool() const {
+    return _pool;
+  }
+
   VariantData& data() {
     return _data;
   }
 
+  const VariantData& data() const {
+    return _data;
+  }
+
   ArrayRef createNestedArray() {
     return addElement().to<ArrayRef>();
   }
@@ -306,7 +328,32 @@ class JsonDocument : public Visitable {
   }
 
   void replacePool(MemoryPool pool) {
+#if ARDUINOJSON_ENABLE_POOL_STATS
+    // keep the statistics that accumulate across clear()
+    MemoryPoolStats stats = _pool.stats();
+    stats.clearContent();
+    _pool = pool;
+    _pool.stats() = stats;
+#else
     _pool = pool;
+#endif
+  }
+
+  // Copies the memory pool of src byte for byte and relocates the pointers.
+  // It's much faster than set(), but it keeps the garbage of src.
+  // Falls back to set() if the strings of src are in a zero-copy input, so
+  // that the copy doesn't depend on that input.
+  void cloneFrom(const JsonDocument& src) {
+    if (&src == this)
+      return;
+    PoolRelocation relocation;
+    if (_pool.cloneFrom(src._pool, relocation)) {
+      _data = src._data;
+      _data.movePointers(relocation);
+      if (!relocation.skippedStrings)
+        return;
+    }
+    set(src);
   }
 
   VariantRef getVariant() {
@@ -0,0 +1,158 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Document/DynamicJsonDocument.hpp>
+
+#if ARDUINOJSON_ENABLE_STD_MUTEX
+
+#include <ArduinoJson/Memory/Alignment.hpp>
+#include <ArduinoJson/Polyfills/utility.hpp>
+
+#include <mutex>
+#include <new>  // placement new
+
+namespace ARDUINOJSON_NAMESPACE {
+
+// Recycles documents to avoid allocating a new memory pool for each request.
+// acquire() returns an empty document, release() gives it back; it only takes
+// a Document, so that a document that doesn't come from a pool doesn't
+// compile.
+// The capacity of the documents follows the highest memoryUsage() observed,
+// so that a document that was too small is replaced by a larger one, but it
+// never exceeds maxCapa, so that hostile inputs can't make the documents grow
+// without bounds. By default, maxCapa is defaultGrowthFactor * capa; pass
+// capa to keep the documents from growing.
+// A released document larger than maxCapa is destroyed.
+// All functions are thread-safe, provided that TAllocator is.
+// CAUTION: every document must be released before the pool is destroyed.
+template <typename TAllocator>
+class BasicJsonDocumentPool {
+ public:
+  static const size_t defaultGrowthFactor = 4;
+
+  // A document of the pool, as returned by acquire()
+  class Document : public BasicJsonDocument<TAllocator> {
+   public:
+    using BasicJsonDocument<TAllocator>::operator=;
+
+   private:
+    friend class BasicJsonDocumentPool;
+
+    Document(size_t capa, TAllocator alloc)
+        : BasicJsonDocument<TAllocator>(capa, alloc), _next(0) {}
+
+    // only the pool makes Documents
+    Document(const Document&);
+
+    Document* _next;
+  };
+
+  // maxCapa == 0 means defaultGrowthFactor * capa
+  explicit BasicJsonDocumentPool(size_t capa, size_t maxCapa = 0,
+                                 TAllocator alloc = TAllocator())
+      : _allocator(alloc),
+        _capacity(addPadding(capa)),
+        _maxCapacity(addPadding(maxCapa == 0     ? defaultGrowthFactor * capa
+                                : maxCapa > capa ? maxCapa
+                                                 : capa)),
+        _free(0) {}
+
+  ~BasicJsonDocumentPool() {
+    while (_free) {
+      Document* doc = _free;
+      _free = doc->_next;
+      destroy(doc);
+    }
+  }
+
+  // Returns an empty document, or null if the allocation fails
+  Document* acquire() {
+    Document* doc;
+    size_t capacity;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      doc = _free;
+      if (doc)
+        _free = doc->_next;
+      capacity = _capacity;
+    }
+
+    if (doc && doc->capacity() < capacity) {
+      destroy(doc);
+      doc = 0;
+    }
+    if (!doc)
+      doc = create(capacity);
+    return doc;
+  }
+
+  void release(Document* doc) {
+    if (!doc)
+      return;
+    if (doc->capacity() > _maxCapacity) {
+      destroy(doc);
+      return;
+    }
+    size_t usage = doc->memoryUsage();
+    // the document was full: it probably failed with NoMemory
+    bool full = usage + sizeof(VariantSlot) > doc->capacity();
+    doc->clear();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (full)
+      usage = 2 * doc->capacity();
+    if (usage > _maxCapacity)
+      usage = _maxCapacity;
+    if (usage > _capacity)
+      _capacity = addPadding(usage);
+    doc->_next = _free;
+    _free = doc;
+  }
+
+  // Capacity of the next documents
+  size_t capacity() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _capacity;
+  }
+
+  // Limit of capacity()
+  size_t maxCapacity() const {
+    return _maxCapacity;
+  }
+
+ private:
+  BasicJsonDocumentPool(const BasicJsonDocumentPool&);
+  BasicJsonDocumentPool& operator=(const BasicJsonDocumentPool&);
+
+  Document* create(size_t capacity) {
+    void* p = _allocator.allocate(sizeof(Document));
+    if (!p)
+      return 0;
+    Document* doc = new (p) Document(capacity, _allocator);
+    if (doc->capacity() < capacity) {
+      destroy(doc);
+      return 0;
+    }
+    return doc;
+  }
+
+  void destroy(Document* doc) {
+    doc->~Document();
+    _allocator.deallocate(doc);
+  }
+
+  TAllocator _allocator;
+  mutable std::mutex _mutex;
+  size_t _capacity;
+  const size_t _maxCapacity;
+  Document* _free;
+};
+
+typedef BasicJsonDocumentPool<DefaultAllocator> JsonDocumentPool;
+
+}  // namespace ARDUINOJSON_NAMESPACE
+
+#endif
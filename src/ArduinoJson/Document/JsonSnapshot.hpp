@@ -0,0 +1,149 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Document/DynamicJsonDocument.hpp>
+
+#if ARDUINOJSON_ENABLE_STD_ATOMIC
+
+#include <ArduinoJson/Polyfills/utility.hpp>
+
+#include <atomic>
+#include <new>  // placement new
+
+namespace ARDUINOJSON_NAMESPACE {
+
+// An immutable document that can be shared between threads.
+// It takes the memory pool of a document and counts the references to it;
+// the last copy releases the pool.
+// Reading doesn't write anything in the pool, so several threads can read the
+// same snapshot concurrently, without locking.
+// CAUTION: copying, assigning, or destroying a given BasicJsonSnapshot object
+// is not thread-safe; each thread must use its own copy.
+template <typename TAllocator>
+class BasicJsonSnapshot : public Visitable {
+ public:
+  BasicJsonSnapshot() : _shared(0) {}
+
+  // Takes the content of the document.
+  // The snapshot is null if it can't allocate its control block.
+  explicit BasicJsonSnapshot(BasicJsonDocument<TAllocator>&& doc)
+      : _shared(0) {
+    void* p = doc.allocator().allocate(sizeof(Shared));
+    if (p)
+      _shared = new (p) Shared(move(doc));
+  }
+
+  BasicJsonSnapshot(const BasicJsonSnapshot& src) : _shared(src._shared) {
+    if (_shared)
+      _shared->refs.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  BasicJsonSnapshot(BasicJsonSnapshot&& src) : _shared(src._shared) {
+    src._shared = 0;
+  }
+
+  ~BasicJsonSnapshot() {
+    release();
+  }
+
+  BasicJsonSnapshot& operator=(const BasicJsonSnapshot& src) {
+    BasicJsonSnapshot tmp(src);
+    swap(_shared, tmp._shared);
+    return *this;
+  }
+
+  BasicJsonSnapshot& operator=(BasicJsonSnapshot&& src) {
+    swap(_shared, src._shared);
+    return *this;
+  }
+
+  template <typename Visitor>
+  void accept(Visitor& visitor) const {
+    return getVariant().accept(visitor);
+  }
+
+  template <typename T>
+  typename VariantConstAs<T>::type as() const {
+    return getVariant().template as<T>();
+  }
+
+  template <typename T>
+  bool is() const {
+    return getVariant().template is<T>();
+  }
+
+  bool isNull() const {
+    return getVariant().isNull();
+  }
+
+  size_t memoryUsage() const {
+    return _shared ? _shared->doc.memoryUsage() : 0;
+  }
+
+  size_t size() const {
+    return getVariant().size();
+  }
+
+  // operator[](const std::string&) const
+  // operator[](const String&) const
+  template <typename TString>
+  FORCE_INLINE
+      typename enable_if<IsString<TString>::value, VariantConstRef>::type
+      operator[](const TString& key) const {
+    return getVariant()[key];
+  }
+
+  // operator[](char*) const
+  // operator[](const char*) const
+  // operator[](const __FlashStringHelper*) const
+  template <typename TChar>
+  FORCE_INLINE
+      typename enable_if<IsString<TChar*>::value, VariantConstRef>::type
+      operator[](TChar* key) const {
+    return getVariant()[key];
+  }
+
+  FORCE_INLINE VariantConstRef operator[](size_t index) const {
+    return getVariant()[index];
+  }
+
+  // The returned reference remains valid as long as one copy of the snapshot
+  // exists
+  VariantConstRef getVariant() const {
+    if (!_shared)
+      return VariantConstRef(0);
+    const JsonDocument& doc = _shared->doc;
+    return doc.as<VariantConstRef>();
+  }
+
+ private:
+  struct Shared {
+    Shared(BasicJsonDocument<TAllocator>&& d) : refs(1), doc(move(d)) {}
+
+    std::atomic<size_t> refs;
+    BasicJsonDocument<TAllocator> doc;
+  };
+
+  void release() {
+    if (!_shared)
+      return;
+    // the last reader must see every read of the others before freeing
+    if (_shared->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      TAllocator allocator(_shared->doc.allocator());
+      _shared->~Shared();
+      allocator.deallocate(_shared);
+    }
+    _shared = 0;
+  }
+
+  Shared* _shared;
+};
+
+typedef BasicJsonSnapshot<DefaultAllocator> JsonSnapshot;
+
+}  // namespace ARDUINOJSON_NAMESPACE
+
+#endif
@@ -0,0 +1,115 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Document/BasicJsonDocument.hpp>
+
+#if ARDUINOJSON_ENABLE_STD_PMR
+
+#include <memory_resource>
+#include <new>  // std::bad_alloc
+
+#include <stddef.h>  // max_align_t
+#include <string.h>  // memcpy
+
+namespace ARDUINOJSON_NAMESPACE {
+
+// Allocator for BasicJsonDocument that takes the memory from a
+// std::pmr::memory_resource.
+//
+// Each block starts with a header that remembers its size (deallocate()
+// needs it) and the resource it comes from. This way, a block always returns
+// to its resource, even when a document takes the pool of another document
+// (move-constructor and move-assignment) whose allocator uses a different
+// resource.
+//
+// A copy of a document uses the same resource as the original.
+//
+// By default, shrinkToFit() moves the pool to a smaller block, like realloc()
+// would. Set keepShrunkBlocks for a resource that never reuses the memory,
+// like std::pmr::monotonic_buffer_resource: the block is then kept as is,
+// instead of taking a second, smaller copy from the resource.
+class PmrAllocator {
+ public:
+  PmrAllocator()
+      : _resource(std::pmr::get_default_resource()), _keepShrunkBlocks(false) {}
+
+  PmrAllocator(std::pmr::memory_resource* resource,
+               bool keepShrunkBlocks = false)
+      : _resource(resource), _keepShrunkBlocks(keepShrunkBlocks) {}
+
+  void* allocate(size_t size) {
+    return allocate(_resource, size);
+  }
+
+  void deallocate(void* ptr) {
+    Header* header = headerOf(ptr);
+    header->resource->deallocate(header, header->size, alignment);
+  }
+
+  // Emulates realloc(), as memory_resource doesn't support it.
+  // When a block is kept, its header keeps the original size, so that
+  // deallocate() gives back the right size.
+  void* reallocate(void* ptr, size_t new_size) {
+    if (!ptr)
+      return allocate(new_size);
+    Header* header = headerOf(ptr);
+    size_t old_size = header->size - sizeof(Header);
+    if (new_size == old_size || (new_size < old_size && _keepShrunkBlocks))
+      return ptr;
+    void* new_ptr = allocate(header->resource, new_size);
+    if (!new_ptr)
+      // like realloc(), a block that can't shrink stays valid
+      return new_size < old_size ? ptr : 0;
+    memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
+    deallocate(ptr);
+    return new_ptr;
+  }
+
+  std::pmr::memory_resource* resource() const {
+    return _resource;
+  }
+
+ private:
+  static const size_t alignment = alignof(max_align_t);
+
+  struct alignas(max_align_t) Header {
+    std::pmr::memory_resource* resource;
+    size_t size;  // including the header
+  };
+
+  static Header* headerOf(void* ptr) {
+    return reinterpret_cast<Header*>(ptr) - 1;
+  }
+
+  static void* allocate(std::pmr::memory_resource* resource, size_t size) {
+    size_t total = sizeof(Header) + size;
+    void* p;
+#ifdef __cpp_exceptions
+    try {
+      p = resource->allocate(total, alignment);
+    } catch (const std::bad_alloc&) {
+      return 0;
+    }
+#else
+    p = resource->allocate(total, alignment);
+#endif
+    if (!p)
+      return 0;
+    Header* header = reinterpret_cast<Header*>(p);
+    header->resource = resource;
+    header->size = total;
+    return header + 1;
+  }
+
+  std::pmr::memory_resource* _resource;
+  bool _keepShrunkBlocks;
+};
+
+typedef BasicJsonDocument<PmrAllocator> PmrJsonDocument;
+
+}  // namespace ARDUINOJSON_NAMESPACE
+
+#endif
@@ -18,7 +18,7 @@ class StaticJsonDocument : public JsonDocument {
 
   StaticJsonDocument(const StaticJsonDocument& src)
       : JsonDocument(_buffer, _capacity) {
-    set(src);
+    cloneFrom(src);
   }
 
   template <typename T>
@@ -34,7 +34,7 @@ class StaticJsonDocument : public JsonDocument {
   }
 
   StaticJsonDocument operator=(const StaticJsonDocument& src) {
-    set(src);
+    cloneFrom(src);
     return *this;
   }
 
@@ -10,6 +10,11 @@ namespace ARDUINOJSON_NAMESPACE {
 
 class EscapeSequence {
  public:
+  // Tells if the char must be escaped in a JSON string
+  static bool needsEscaping(char c) {
+    return static_cast<unsigned char>(c) < 0x20 || c == '\"' || c == '\\';
+  }
+
   // Optimized for code size on a 8-bit AVR
   static char escapeChar(char c) {
     const char *p = escapeTable(true);
@@ -240,6 +240,8 @@ class JsonDeserializer {
       TFilter memberFilter = filter[key.value];
 
       if (memberFilter.allow()) {
+        key.value = _pool->internKey(key.value);
+
         VariantData *variant = object.getMember(adaptString(key.value));
         if (!variant) {
           // Allocate slot in object
@@ -248,6 +250,7 @@ class JsonDeserializer {
             return DeserializationError::NoMemory;
 
           slot->setOwnedKey(make_not_null(key.value));
+          object.indexMember(slot, _pool);
 
           variant = slot->data();
         }
@@ -344,7 +347,10 @@ class JsonDeserializer {
     StringOrError result = parseQuotedString();
     if (result.err)
       return result.err;
-    variant.setOwnedString(make_not_null(result.value));
+    if (variant.setInlineString(result.value))
+      _stringStorage.reclaim(result.value);
+    else
+      variant.setOwnedString(make_not_null(result.value));
     return DeserializationError::Ok;
   }
 
@@ -380,7 +386,17 @@ class JsonDeserializer {
             Utf8::encodeCodepoint(codepoint.value(), builder);
           continue;
 #else
-          return DeserializationError::NotSupported;
+          // only ASCII, like the control characters that TextFormatter
+          // escapes
+          move();
+          uint16_t codeunit;
+          DeserializationError err = parseHex4(codeunit);
+          if (err)
+            return err;
+          if (codeunit >= 0x80)
+            return DeserializationError::NotSupported;
+          builder.append(char(codeunit));
+          continue;
 #endif
         }
         // replace char
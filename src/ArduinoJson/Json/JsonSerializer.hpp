@@ -6,6 +6,7 @@
 
 #include <ArduinoJson/Json/TextFormatter.hpp>
 #include <ArduinoJson/Misc/Visitable.hpp>
+#include <ArduinoJson/Serialization/ResumableSerializer.hpp>
 #include <ArduinoJson/Serialization/measure.hpp>
 #include <ArduinoJson/Serialization/serialize.hpp>
 
@@ -14,7 +15,7 @@ namespace ARDUINOJSON_NAMESPACE {
 template <typename TWriter>
 class JsonSerializer {
  public:
-  JsonSerializer(TWriter writer) : _formatter(writer) {}
+  JsonSerializer(TWriter &writer) : _formatter(writer) {}
 
   FORCE_INLINE void visitArray(const CollectionData &array) {
     write('[');
@@ -66,6 +67,15 @@ class JsonSerializer {
     _formatter.writeRaw(data, n);
   }
 
+  // JSON has no binary type
+  void visitBinary(const char *, size_t) {
+    write("null");
+  }
+
+  void visitExtension(const char *, size_t) {
+    write("null");
+  }
+
   void visitNegativeInteger(UInt value) {
     _formatter.writeNegativeInteger(value);
   }
@@ -86,6 +96,66 @@ class JsonSerializer {
     return _formatter.bytesWritten();
   }
 
+  // The tokens of visitArray() and visitObject(), for ResumableSerializer
+
+  void beginArray(const CollectionData &) {
+    write('[');
+  }
+
+  void beginObject(const CollectionData &) {
+    write('{');
+  }
+
+  void endArray() {
+    write(']');
+  }
+
+  void endObject() {
+    write('}');
+  }
+
+  void writeKey(const char *key) {
+    _formatter.writeString(key);
+    write(':');
+  }
+
+  void writeSeparator() {
+    write(',');
+  }
+
+  // The parts of visitString(), visitRawJson(), visitBinary(), and
+  // visitExtension(), for ResumableSerializer
+
+  void beginString(size_t) {
+    write('"');
+  }
+
+  void writeStringPart(const char *s, size_t n) {
+    _formatter.writeStringPart(s, n);
+  }
+
+  void endString() {
+    write('"');
+  }
+
+  void writeKeySeparator() {
+    write(':');
+  }
+
+  void writeRawPart(const char *s, size_t n) {
+    _formatter.writeRaw(s, n);
+  }
+
+  void beginBinary(size_t) {
+    write("null");
+  }
+
+  void beginExtension(size_t) {
+    write("null");
+  }
+
+  void writeBinaryPart(const char *, size_t) {}
+
  protected:
   void write(char c) {
     _formatter.writeRaw(c);
@@ -99,6 +169,8 @@ class JsonSerializer {
   TextFormatter<TWriter> _formatter;
 };
 
+typedef ResumableSerializer<JsonSerializer> ResumableJsonSerializer;
+
 template <typename TSource, typename TDestination>
 size_t serializeJson(const TSource &source, TDestination &destination) {
   return serialize<JsonSerializer>(source, destination);
@@ -0,0 +1,211 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Json/TextFormatter.hpp>
+#include <ArduinoJson/Misc/SerializedValue.hpp>
+#include <ArduinoJson/Numbers/Float.hpp>
+#include <ArduinoJson/Numbers/Integer.hpp>
+#include <ArduinoJson/Polyfills/type_traits.hpp>
+#include <ArduinoJson/Serialization/Writer.hpp>
+
+namespace ARDUINOJSON_NAMESPACE {
+
+// Writes JSON directly to the destination, without a JsonDocument.
+//
+//   JsonWriter<std::string> json(output);
+//   json.beginObject();
+//   json.key("values");
+//   json.beginArray();
+//   json.value(42);
+//   json.end();
+//   json.end();
+//
+// The functions return false, and write nothing, when they're called at the
+// wrong place (for example, value() in an object without key()), or when the
+// nesting exceeds ARDUINOJSON_DEFAULT_NESTING_LIMIT.
+// CAUTION: some writers buffer the output (std::string, String, std::ostream),
+// so the output is complete only when the JsonWriter is destroyed.
+template <typename TDestination>
+class JsonWriter {
+  static const size_t maxDepth = ARDUINOJSON_DEFAULT_NESTING_LIMIT;
+
+ public:
+  explicit JsonWriter(TDestination &destination)
+      : _writer(destination),
+        _formatter(_writer),
+        _depth(0),
+        _first(true),
+        _afterKey(false),
+        _complete(false) {}
+
+  bool beginArray() {
+    return beginCollection(false);
+  }
+
+  bool beginObject() {
+    return beginCollection(true);
+  }
+
+  // Closes the current array or object
+  bool end() {
+    if (_depth == 0 || _afterKey)
+      return false;
+    _depth--;
+    _formatter.writeRaw(_isObject[_depth] ? '}' : ']');
+    endValue();
+    return true;
+  }
+
+  bool key(const char *s) {
+    if (!s || _depth == 0 || !_isObject[_depth - 1] || _afterKey)
+      return false;
+    if (!_first)
+      _formatter.writeRaw(',');
+    _formatter.writeString(s);
+    _formatter.writeRaw(':');
+    _afterKey = true;
+    return true;
+  }
+
+#if ARDUINOJSON_ENABLE_STD_STRING
+  bool key(const std::string &s) {
+    return key(s.c_str());
+  }
+#endif
+
+#if ARDUINOJSON_ENABLE_ARDUINO_STRING
+  bool key(const ::String &s) {
+    return key(s.c_str());
+  }
+#endif
+
+  // Writes a string, or null if s is null
+  bool value(const char *s) {
+    if (!beginValue())
+      return false;
+    if (s)
+      _formatter.writeString(s);
+    else
+      _formatter.writeRaw("null");
+    return endValue();
+  }
+
+#if ARDUINOJSON_ENABLE_STD_STRING
+  bool value(const std::string &s) {
+    return value(s.c_str());
+  }
+#endif
+
+#if ARDUINOJSON_ENABLE_ARDUINO_STRING
+  bool value(const ::String &s) {
+    return value(s.c_str());
+  }
+#endif
+
+  bool value(bool b) {
+    if (!beginValue())
+      return false;
+    _formatter.writeBoolean(b);
+    return endValue();
+  }
+
+  template <typename T>
+  typename enable_if<is_integral<T>::value && is_signed<T>::value, bool>::type
+  value(T n) {
+    if (!beginValue())
+      return false;
+    if (n >= 0)
+      _formatter.writePositiveInteger(static_cast<UInt>(n));
+    else
+      _formatter.writeNegativeInteger(~static_cast<UInt>(n) + 1);
+    return endValue();
+  }
+
+  template <typename T>
+  typename enable_if<is_integral<T>::value && is_unsigned<T>::value, bool>::type
+  value(T n) {
+    if (!beginValue())
+      return false;
+    _formatter.writePositiveInteger(static_cast<UInt>(n));
+    return endValue();
+  }
+
+  template <typename T>
+  typename enable_if<is_floating_point<T>::value, bool>::type value(T n) {
+    if (!beginValue())
+      return false;
+    _formatter.writeFloat(static_cast<Float>(n));
+    return endValue();
+  }
+
+  // Writes pregenerated JSON, see serialized()
+  template <typename T>
+  bool value(SerializedValue<T> raw) {
+    if (!beginValue())
+      return false;
+    _formatter.writeRaw(raw.data(), raw.size());
+    return endValue();
+  }
+
+  bool null() {
+    if (!beginValue())
+      return false;
+    _formatter.writeRaw("null");
+    return endValue();
+  }
+
+  // Tells if the root value is completely written
+  bool complete() const {
+    return _complete;
+  }
+
+  size_t bytesWritten() const {
+    return _formatter.bytesWritten();
+  }
+
+ private:
+  JsonWriter(const JsonWriter &);  // non-copyable, see TextFormatter
+  JsonWriter &operator=(const JsonWriter &);
+
+  bool beginCollection(bool isObject) {
+    if (_depth >= maxDepth || !beginValue())
+      return false;
+    _formatter.writeRaw(isObject ? '{' : '[');
+    _isObject[_depth++] = isObject;
+    _first = true;
+    _afterKey = false;
+    return true;
+  }
+
+  // Checks that a value is expected, and writes the comma if needed
+  bool beginValue() {
+    if (_depth == 0)
+      return !_complete;
+    if (_isObject[_depth - 1])
+      return _afterKey;
+    if (!_first)
+      _formatter.writeRaw(',');
+    return true;
+  }
+
+  bool endValue() {
+    if (_depth == 0)
+      _complete = true;
+    _first = false;
+    _afterKey = false;
+    return true;
+  }
+
+  Writer<TDestination> _writer;
+  TextFormatter<Writer<TDestination> > _formatter;
+  bool _isObject[maxDepth];
+  size_t _depth;
+  bool _first;
+  bool _afterKey;
+  bool _complete;
+};
+
+}  // namespace ARDUINOJSON_NAMESPACE
@@ -0,0 +1,204 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Json/JsonSerializer.hpp>
+
+#if ARDUINOJSON_ENABLE_STD_THREAD
+
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace ARDUINOJSON_NAMESPACE {
+
+// Finds the array or object at the root of the source
+class RootCollectionFinder {
+ public:
+  RootCollectionFinder() : collection(0), isObject(false) {}
+
+  void visitArray(const CollectionData &array) {
+    collection = &array;
+  }
+
+  void visitObject(const CollectionData &object) {
+    collection = &object;
+    isObject = true;
+  }
+
+  void visitFloat(Float) {}
+  void visitString(const char *) {}
+  void visitRawJson(const char *, size_t) {}
+  void visitBinary(const char *, size_t) {}
+  void visitExtension(const char *, size_t) {}
+  void visitNegativeInteger(UInt) {}
+  void visitPositiveInteger(UInt) {}
+  void visitBoolean(bool) {}
+  void visitNull() {}
+
+  const CollectionData *collection;
+  bool isObject;
+};
+
+// Serializes the elements, or the members, in [begin, end)
+template <typename TSerializer>
+void serializeJsonRange(TSerializer &serializer, const VariantSlot *begin,
+                        const VariantSlot *end, bool isObject) {
+  for (const VariantSlot *slot = begin; slot != end; slot = slot->next()) {
+    if (slot != begin)
+      serializer.writeSeparator();
+    if (isObject)
+      serializer.writeKey(slot->key());
+    slot->data()->accept(serializer);
+  }
+}
+
+// Below this number of elements per thread, starting a thread costs more than
+// it saves
+const size_t minElementsPerParallelThread = 1024;
+
+// Joins the threads when it leaves the scope, even because of an exception,
+// as destroying a joinable std::thread calls std::terminate()
+class ThreadJoiner {
+ public:
+  ThreadJoiner(std::vector<std::thread> &threads) : _threads(threads) {}
+
+  ~ThreadJoiner() {
+    for (size_t i = 0; i < _threads.size(); i++) {
+      if (_threads[i].joinable())
+        _threads[i].join();
+    }
+  }
+
+ private:
+  ThreadJoiner(const ThreadJoiner &);
+  ThreadJoiner &operator=(const ThreadJoiner &);
+
+  std::vector<std::thread> &_threads;
+};
+
+// The source of serializeJsonParallel(), which goes through serialize() like
+// the source of serializeJson(), so that it supports the same destinations.
+// The calling thread writes the first range to the destination, while the
+// other threads write the following ranges to temporary strings, which are
+// then copied to the destination in order.
+template <typename TSource>
+class ParallelJsonSource {
+ public:
+  ParallelJsonSource(const TSource &source, size_t threads)
+      : _source(source), _threads(threads) {}
+
+  template <typename Visitor>
+  void accept(Visitor &serializer) const {
+    RootCollectionFinder root;
+    _source.accept(root);
+
+    size_t threads = _threads;
+    if (threads == 0)
+      threads = std::thread::hardware_concurrency();
+    size_t size = root.collection ? root.collection->size() : 0;
+    if (threads > size / minElementsPerParallelThread)
+      threads = size / minElementsPerParallelThread;
+    if (threads <= 1) {
+      _source.accept(serializer);
+      return;
+    }
+
+    // split the collection in ranges of the same number of elements
+    std::vector<const VariantSlot *> bounds;
+    bounds.reserve(threads + 1);
+    const VariantSlot *slot = root.collection->head();
+    for (size_t i = 0; i < size; i++, slot = slot->next()) {
+      if (i == bounds.size() * size / threads)
+        bounds.push_back(slot);
+    }
+    bounds.push_back(0);
+
+    std::vector<std::string> outputs(threads);
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    ThreadJoiner joiner(workers);
+    startWorkers(workers, outputs, bounds, root.isObject);
+
+    if (root.isObject)
+      serializer.beginObject(*root.collection);
+    else
+      serializer.beginArray(*root.collection);
+    serializeJsonRange(serializer, bounds[0], bounds[1], root.isObject);
+
+    for (size_t i = 1; i < threads; i++) {
+      serializer.writeSeparator();
+      if (i <= workers.size()) {
+        workers[i - 1].join();
+        serializer.visitRawJson(outputs[i].data(), outputs[i].size());
+      } else {
+        // this thread couldn't start
+        serializeJsonRange(serializer, bounds[i], bounds[i + 1],
+                           root.isObject);
+      }
+    }
+
+    if (root.isObject)
+      serializer.endObject();
+    else
+      serializer.endArray();
+  }
+
+ private:
+  // Starts one thread per range, except the first.
+  // Stops at the first thread that can't start (std::system_error); the
+  // calling thread then serializes the remaining ranges.
+  static void startWorkers(std::vector<std::thread> &workers,
+                           std::vector<std::string> &outputs,
+                           const std::vector<const VariantSlot *> &bounds,
+                           bool isObject) {
+    for (size_t i = 1; i < outputs.size(); i++) {
+      std::string *output = &outputs[i];
+      const VariantSlot *begin = bounds[i];
+      const VariantSlot *end = bounds[i + 1];
+#ifdef __cpp_exceptions
+      try {
+#endif
+        workers.push_back(std::thread([output, begin, end, isObject]() {
+          Writer<std::string> writer(*output);
+          JsonSerializer<Writer<std::string> > serializer(writer);
+          serializeJsonRange(serializer, begin, end, isObject);
+        }));
+#ifdef __cpp_exceptions
+      } catch (const std::system_error &) {
+        return;
+      }
+#endif
+    }
+  }
+
+  const TSource &_source;
+  size_t _threads;
+};
+
+// Produces the same output as serializeJson(), but serializes the elements of
+// the root array (or the members of the root object) with several threads.
+// When threads is 0, it uses std::thread::hardware_concurrency().
+// CAUTION: the document must not change until the function returns.
+template <typename TSource, typename TDestination>
+size_t serializeJsonParallel(const TSource &source, TDestination &destination,
+                             size_t threads = 0) {
+  return serialize<JsonSerializer>(ParallelJsonSource<TSource>(source, threads),
+                                   destination);
+}
+
+// CAUTION: unlike serializeJson(), threads isn't optional, so that a call
+// with a char* and a size doesn't take the size for the number of threads.
+template <typename TSource>
+size_t serializeJsonParallel(const TSource &source, void *buffer,
+                             size_t bufferSize, size_t threads) {
+  return serialize<JsonSerializer>(ParallelJsonSource<TSource>(source, threads),
+                                   buffer, bufferSize);
+}
+
+}  // namespace ARDUINOJSON_NAMESPACE
+
+#endif
@@ -18,7 +18,8 @@ namespace ARDUINOJSON_NAMESPACE {
 template <typename TWriter>
 class TextFormatter {
  public:
-  explicit TextFormatter(TWriter writer) : _writer(writer), _length(0) {}
+  // The writer is held by reference, because some of them have a buffer
+  explicit TextFormatter(TWriter &writer) : _writer(writer), _length(0) {}
 
   // Returns the number of bytes sent to the TWriter implementation.
   size_t bytesWritten() const {
@@ -35,18 +36,40 @@ class TextFormatter {
   void writeString(const char *value) {
     ARDUINOJSON_ASSERT(value != NULL);
     writeRaw('\"');
-    while (*value) writeChar(*value++);
+    // write the runs of regular chars in one call
+    const char *run = value;
+    for (; *value; value++) {
+      if (!EscapeSequence::needsEscaping(*value))
+        continue;
+      if (value > run)
+        writeRaw(run, value);
+      writeEscapedChar(*value);
+      run = value + 1;
+    }
+    writeRaw(run, value);
     writeRaw('\"');
   }
 
+  // Writes n chars of a string, without the quotes
+  void writeStringPart(const char *s, size_t n) {
+    const char *end = s + n;
+    const char *run = s;
+    for (; s < end; s++) {
+      if (!EscapeSequence::needsEscaping(*s))
+        continue;
+      if (s > run)
+        writeRaw(run, s);
+      writeEscapedChar(*s);
+      run = s + 1;
+    }
+    writeRaw(run, end);
+  }
+
   void writeChar(char c) {
-    char specialChar = EscapeSequence::escapeChar(c);
-    if (specialChar) {
-      writeRaw('\\');
-      writeRaw(specialChar);
-    } else {
+    if (EscapeSequence::needsEscaping(c))
+      writeEscapedChar(c);
+    else
       writeRaw(c);
-    }
   }
 
   template <typename T>
@@ -149,10 +172,28 @@ class TextFormatter {
   }
 
  protected:
-  TWriter _writer;
+  TWriter &_writer;
   size_t _length;
 
  private:
+  void writeEscapedChar(char c) {
+    writeRaw('\\');
+    char specialChar = EscapeSequence::escapeChar(c);
+    if (specialChar) {
+      writeRaw(specialChar);
+    } else {
+      // other control characters
+      uint8_t code = static_cast<uint8_t>(c);
+      writeRaw("u00");
+      writeRaw(hexDigit(uint8_t(code >> 4)));
+      writeRaw(hexDigit(uint8_t(code & 0xF)));
+    }
+  }
+
+  static char hexDigit(uint8_t n) {
+    return char(n < 10 ? '0' + n : 'a' + n - 10);
+  }
+
   TextFormatter &operator=(const TextFormatter &);  // cannot be assigned
 };
 }  // namespace ARDUINOJSON_NAMESPACE
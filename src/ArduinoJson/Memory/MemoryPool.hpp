@@ -5,12 +5,15 @@
 #pragma once
 
 #include <ArduinoJson/Memory/Alignment.hpp>
+#include <ArduinoJson/Memory/MemoryPoolStats.hpp>
+#include <ArduinoJson/Memory/PoolRelocation.hpp>
 #include <ArduinoJson/Memory/StringSlot.hpp>
 #include <ArduinoJson/Polyfills/assert.hpp>
 #include <ArduinoJson/Polyfills/mpl/max.hpp>
+#include <ArduinoJson/Strings/StringHasher.hpp>
 #include <ArduinoJson/Variant/VariantSlot.hpp>
 
-#include <string.h>  // memmove
+#include <string.h>  // memcpy, memmove, memset, strcmp
 
 namespace ARDUINOJSON_NAMESPACE {
 
@@ -29,6 +32,15 @@ class MemoryPool {
         _left(buf),
         _right(buf ? buf + capa : 0),
         _end(buf ? buf + capa : 0) {
+#if ARDUINOJSON_ENABLE_KEY_INTERNING
+    _keys = 0;
+#endif
+#if ARDUINOJSON_ENABLE_COLLECTION_INDEX
+    resetIndexFailures();
+#endif
+#if ARDUINOJSON_ENABLE_POOL_STATS
+    _stats.reset();
+#endif
     ARDUINOJSON_ASSERT(isAligned(_begin));
     ARDUINOJSON_ASSERT(isAligned(_right));
     ARDUINOJSON_ASSERT(isAligned(_end));
@@ -47,16 +59,60 @@ class MemoryPool {
     return size_t(_left - _begin + _end - _right);
   }
 
+  size_t stringsSize() const {
+    return size_t(_left - _begin);
+  }
+
+  size_t variantsSize() const {
+    return size_t(_end - _right);
+  }
+
+#if ARDUINOJSON_ENABLE_POOL_STATS
+  const MemoryPoolStats& stats() const {
+    return _stats;
+  }
+
+  MemoryPoolStats& stats() {
+    return _stats;
+  }
+#endif
+
   VariantSlot* allocVariant() {
-    return allocRight<VariantSlot>();
+    VariantSlot* slot = allocRight<VariantSlot>();
+    if (slot)
+      countSlots(1);
+    return slot;
+  }
+
+  // Allocates n contiguous slots, the first one at the lowest address
+  VariantSlot* allocVariants(size_t n) {
+    if (n > size_t(_right - _left) / sizeof(VariantSlot)) {
+      countFailure();
+      return 0;
+    }
+    VariantSlot* slots =
+        reinterpret_cast<VariantSlot*>(allocRight(n * sizeof(VariantSlot)));
+    if (slots)
+      countSlots(n);
+    return slots;
+  }
+
+  // Where allocVariants(n) would put the slots, or null if they don't fit
+  VariantSlot* nextVariants(size_t n) const {
+    if (n > size_t(_right - _left) / sizeof(VariantSlot))
+      return 0;
+    return reinterpret_cast<VariantSlot*>(_right) - n;
   }
 
   char* allocFrozenString(size_t n) {
-    if (!canAlloc(n))
+    if (!canAlloc(n)) {
+      countFailure();
       return 0;
+    }
     char* s = _left;
     _left += n;
     checkInvariants();
+    countString();
     return s;
   }
 
@@ -73,22 +129,76 @@ class MemoryPool {
     _left -= (s.size - newSize);
     s.size = newSize;
     checkInvariants();
+    countString();
+  }
+
+  // Called when an expandable string overflowed
+  void discardString() {
+    countFailure();
   }
 
   void reclaimLastString(const char* s) {
+#if ARDUINOJSON_ENABLE_POOL_STATS
+    _stats.reclaimedBytes += size_t(_left - s);
+    _stats.strings--;
+#endif
     _left = const_cast<char*>(s);
   }
 
+  // Returns the copy of the key that was stored first.
+  // CAUTION: s must be the last string allocated in the pool, because it is
+  // released when the key has already been stored.
+  const char* internKey(const char* s) {
+#if ARDUINOJSON_ENABLE_KEY_INTERNING
+    if (!owns(s))
+      return s;
+
+    if (!_keys) {
+      _keys = reinterpret_cast<InternedKeys*>(
+          allocVariantBlock(sizeof(InternedKeys)));
+      if (!_keys)
+        return s;
+      memset(_keys, 0, sizeof(InternedKeys));
+    }
+
+    const size_t mask = ARDUINOJSON_KEY_INTERNING_TABLE_SIZE - 1;
+    size_t i = hashString(s) & mask;
+    for (size_t n = 0; n <= mask; n++, i = (i + 1) & mask) {
+      const char* key = _keys->values[i];
+      if (!key) {
+        _keys->values[i] = s;
+        return s;
+      }
+      if (!strcmp(key, s)) {
+        reclaimLastString(s);
+        return key;
+      }
+    }
+    // the table is full, keep this copy
+#endif
+    return s;
+  }
+
   void clear() {
     _left = _begin;
     _right = _end;
+#if ARDUINOJSON_ENABLE_KEY_INTERNING
+    _keys = 0;
+#endif
+#if ARDUINOJSON_ENABLE_COLLECTION_INDEX
+    resetIndexFailures();
+#endif
+#if ARDUINOJSON_ENABLE_POOL_STATS
+    _stats.clearContent();
+#endif
   }
 
+  // Doesn't compute _left + bytes, which wraps around with a large size
   bool canAlloc(size_t bytes) const {
-    return _left + bytes <= _right;
+    return bytes <= available();
   }
 
-  bool owns(void* p) const {
+  bool owns(const void* p) const {
     return _begin <= p && p < _end;
   }
 
@@ -98,12 +208,65 @@ class MemoryPool {
   }
 
   void* allocRight(size_t bytes) {
-    if (!canAlloc(bytes))
+    if (!canAlloc(bytes)) {
+      countFailure();
       return 0;
+    }
     _right -= bytes;
+    updatePeak();
     return _right;
   }
 
+  // Allocates a block among the variants.
+  // Its size is rounded to a whole number of slots because
+  // VariantSlot::next() counts in slots.
+  void* allocVariantBlock(size_t bytes) {
+    size_t size = variantBlockSize(bytes);
+    void* block = allocRight(size);
+    if (block)
+      countPadding(size - bytes);
+    return block;
+  }
+
+  // Like allocVariantBlock(), but remembers the smallest size that didn't fit
+  // since the last clear(): the pool never gets more room, so the blocks that
+  // are at least that large are refused right away.
+  void* allocIndexBlock(size_t bytes) {
+#if ARDUINOJSON_ENABLE_COLLECTION_INDEX
+    if (_failedIndexSize && bytes >= _failedIndexSize)
+      return 0;
+    void* block = allocVariantBlock(bytes);
+    if (!block)
+      _failedIndexSize = bytes;
+    return block;
+#else
+    return allocVariantBlock(bytes);
+#endif
+  }
+
+#if ARDUINOJSON_ENABLE_COLLECTION_INDEX
+  // Remembers the collection whose index didn't fit, identified by its first
+  // slot, so that it doesn't walk its slots again for each new one.
+  // The other collections can still build a smaller index.
+  void setIndexFailed(const VariantSlot* head) {
+    _failedIndexHead = head;
+  }
+
+  bool indexFailed(const VariantSlot* head) const {
+    return head && head == _failedIndexHead;
+  }
+#endif
+
+  // Number of bytes that can still be allocated
+  size_t available() const {
+    return size_t(_right - _left);
+  }
+
+  static size_t variantBlockSize(size_t bytes) {
+    const size_t n = (bytes + sizeof(VariantSlot) - 1) / sizeof(VariantSlot);
+    return n * sizeof(VariantSlot);
+  }
+
   // Workaround for missing placement new
   void* operator new(size_t, void* p) {
     return p;
@@ -129,11 +292,66 @@ class MemoryPool {
     memmove(new_right, _right, right_size);
 
     ptrdiff_t bytes_reclaimed = _right - new_right;
+    countPadding(size_t(new_right - _left));
     _right = new_right;
     _end = new_right + right_size;
+#if ARDUINOJSON_ENABLE_KEY_INTERNING
+    if (_keys)
+      _keys = reinterpret_cast<InternedKeys*>(
+          reinterpret_cast<char*>(_keys) - bytes_reclaimed);
+#endif
     return bytes_reclaimed;
   }
 
+  // Copies the strings and the variants of another pool, at the same distance
+  // from _begin and _end, so that a single relocation fixes the pointers.
+  // Returns false if this pool is too small.
+  bool cloneFrom(const MemoryPool& src, PoolRelocation& relocation) {
+    size_t left_size = static_cast<size_t>(src._left - src._begin);
+    size_t right_size = static_cast<size_t>(src._end - src._right);
+    if (left_size + right_size > capacity())
+      return false;
+
+    relocation.oldStringsBegin = reinterpret_cast<uintptr_t>(src._begin);
+    relocation.oldStringsEnd = reinterpret_cast<uintptr_t>(src._left);
+    relocation.stringDistance = _begin - src._begin;
+    relocation.variantDistance = _end - src._end;
+    relocation.skippedStrings = false;
+    relocation.linkedStrings = false;
+
+    _left = _begin + left_size;
+    _right = _end - right_size;
+    if (left_size)
+      memcpy(_begin, src._begin, left_size);
+    if (right_size)
+      memcpy(_right, src._right, right_size);
+    checkInvariants();
+
+#if ARDUINOJSON_ENABLE_COLLECTION_INDEX
+    resetIndexFailures();  // this pool may be larger
+#endif
+
+#if ARDUINOJSON_ENABLE_POOL_STATS
+    _stats.paddingBytes = src._stats.paddingBytes;
+    _stats.slots = src._stats.slots;
+    _stats.strings = src._stats.strings;
+    updatePeak();
+#endif
+
+#if ARDUINOJSON_ENABLE_KEY_INTERNING
+    _keys = 0;
+    if (src._keys) {
+      _keys = reinterpret_cast<InternedKeys*>(
+          reinterpret_cast<char*>(src._keys) + relocation.variantDistance);
+      for (size_t i = 0; i < ARDUINOJSON_KEY_INTERNING_TABLE_SIZE; i++) {
+        if (_keys->values[i])
+          relocation.moveString(_keys->values[i]);
+      }
+    }
+#endif
+    return true;
+  }
+
   // Move all pointers together
   // This funcion is called after a realloc.
   void movePointers(ptrdiff_t offset) {
@@ -141,13 +359,68 @@ class MemoryPool {
     _left += offset;
     _right += offset;
     _end += offset;
+#if ARDUINOJSON_ENABLE_KEY_INTERNING
+    if (_keys) {
+      _keys = reinterpret_cast<InternedKeys*>(
+          reinterpret_cast<char*>(_keys) + offset);
+      for (size_t i = 0; i < ARDUINOJSON_KEY_INTERNING_TABLE_SIZE; i++) {
+        if (_keys->values[i])
+          _keys->values[i] += offset;
+      }
+    }
+#endif
   }
 
  private:
+#if ARDUINOJSON_ENABLE_KEY_INTERNING
+  // Open-addressing hash table, allocated in the variant area on first use
+  struct InternedKeys {
+    const char* values[ARDUINOJSON_KEY_INTERNING_TABLE_SIZE];
+  };
+#endif
+
   StringSlot* allocStringSlot() {
     return allocRight<StringSlot>();
   }
 
+  // The following functions do nothing without ARDUINOJSON_ENABLE_POOL_STATS
+
+  void countFailure() {
+#if ARDUINOJSON_ENABLE_POOL_STATS
+    _stats.failedAllocations++;
+#endif
+  }
+
+  void countPadding(size_t bytes) {
+#if ARDUINOJSON_ENABLE_POOL_STATS
+    _stats.paddingBytes += bytes;
+#else
+    (void)bytes;
+#endif
+  }
+
+  void countSlots(size_t n) {
+#if ARDUINOJSON_ENABLE_POOL_STATS
+    _stats.slots += n;
+#else
+    (void)n;
+#endif
+  }
+
+  void countString() {
+#if ARDUINOJSON_ENABLE_POOL_STATS
+    _stats.strings++;
+    updatePeak();
+#endif
+  }
+
+  void updatePeak() {
+#if ARDUINOJSON_ENABLE_POOL_STATS
+    if (size() > _stats.peakUsage)
+      _stats.peakUsage = size();
+#endif
+  }
+
   void checkInvariants() {
     ARDUINOJSON_ASSERT(_begin <= _left);
     ARDUINOJSON_ASSERT(_left <= _right);
@@ -156,6 +429,21 @@ class MemoryPool {
   }
 
   char *_begin, *_left, *_right, *_end;
+#if ARDUINOJSON_ENABLE_KEY_INTERNING
+  InternedKeys* _keys;
+#endif
+#if ARDUINOJSON_ENABLE_COLLECTION_INDEX
+  void resetIndexFailures() {
+    _failedIndexSize = 0;
+    _failedIndexHead = 0;
+  }
+
+  size_t _failedIndexSize;
+  const VariantSlot* _failedIndexHead;
+#endif
+#if ARDUINOJSON_ENABLE_POOL_STATS
+  MemoryPoolStats _stats;
+#endif
 };
 
 }  // namespace ARDUINOJSON_NAMESPACE
@@ -0,0 +1,52 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Namespace.hpp>
+
+#include <stddef.h>  // size_t
+
+namespace ARDUINOJSON_NAMESPACE {
+
+// Statistics of a MemoryPool, collected with ARDUINOJSON_ENABLE_POOL_STATS.
+// They help to choose the capacity of a JsonDocument.
+struct MemoryPoolStats {
+  // Highest memoryUsage(), including before the calls to clear()
+  size_t peakUsage;
+
+  // Number of allocations that failed for lack of memory (NoMemory)
+  size_t failedAllocations;
+
+  // Number of bytes of strings released by reclaimLastString(), because they
+  // were duplicated keys or were moved inside the variant
+  size_t reclaimedBytes;
+
+  // Number of bytes lost to round blocks to whole slots, and to align the
+  // variants after the strings in shrinkToFit()
+  size_t paddingBytes;
+
+  // Number of variant slots allocated since clear()
+  size_t slots;
+
+  // Number of strings in the pool
+  size_t strings;
+
+  // Resets the statistics that describe the content of the pool, but keeps
+  // the ones that accumulate across clear()
+  void clearContent() {
+    paddingBytes = 0;
+    slots = 0;
+    strings = 0;
+  }
+
+  void reset() {
+    peakUsage = 0;
+    failedAllocations = 0;
+    reclaimedBytes = 0;
+    clearContent();
+  }
+};
+
+}  // namespace ARDUINOJSON_NAMESPACE
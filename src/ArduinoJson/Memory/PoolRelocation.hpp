@@ -0,0 +1,108 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Memory/Alignment.hpp>
+
+#include <stddef.h>  // ptrdiff_t
+#include <stdint.h>  // uintptr_t
+
+namespace ARDUINOJSON_NAMESPACE {
+
+// Tells how the content of a memory pool moved, so that the variants can
+// update their pointers.
+// The strings and the variants can move by different distances, because
+// MemoryPool::squash() moves the variants closer to the strings.
+struct PoolRelocation {
+  // Where the strings were before the move.
+  // The "owned" strings outside this range don't belong to the pool (they're
+  // in a zero-copy input), so they stay where they are.
+  // These are addresses, not pointers, because the old buffer may be freed.
+  uintptr_t oldStringsBegin;
+  uintptr_t oldStringsEnd;
+
+  ptrdiff_t stringDistance;
+  ptrdiff_t variantDistance;
+
+  // Set when a string was left in place
+  bool skippedStrings;
+
+  // Set when a linked string was found (they never move)
+  bool linkedStrings;
+
+  // Tells if the string was in the old range
+  bool canMoveString(const char* s) const {
+    uintptr_t address = reinterpret_cast<uintptr_t>(s);
+    return oldStringsBegin <= address && address < oldStringsEnd;
+  }
+
+  void moveString(const char*& s) {
+    if (canMoveString(s))
+      s += stringDistance;
+    else
+      skippedStrings = true;
+  }
+
+  // The following is only for canMovePointers(), which checks a pool that
+  // comes from an untrusted source (see DocumentImage.hpp): the content is
+  // already at its new address, but the pointers still have their old value.
+
+  // Where the variants are now
+  uintptr_t newVariantsBegin;
+  uintptr_t newVariantsEnd;
+
+  // The strings must start before this address, so that they end with a
+  // terminator that's in the pool
+  uintptr_t newStringsLimit;
+
+  // Limits the walk, in case the links form a loop
+  size_t remainingSlots;
+
+  // Tells if the string, at its old address, is in the pool and terminated
+  bool isValidString(const char* s) const {
+    return canMoveString(s) && newAddress(s) < newStringsLimit;
+  }
+
+  // Tells if the bytes, at their old address, are in the pool, as well as
+  // the ones before
+  bool isValidBytes(const char* data, size_t size, size_t before = 0) const {
+    uintptr_t address = reinterpret_cast<uintptr_t>(data);
+    return oldStringsBegin <= address && address <= oldStringsEnd &&
+           before <= address - oldStringsBegin &&
+           size <= oldStringsEnd - address;
+  }
+
+  // Returns the new address of a string
+  const char* movedString(const char* s) const {
+    return reinterpret_cast<const char*>(newAddress(s));
+  }
+
+  // Returns the new address of a block of variants, or null if it's not
+  // entirely in the pool.
+  template <typename T>
+  const T* movedVariant(const T* p, size_t size = sizeof(T)) const {
+    uintptr_t address =
+        reinterpret_cast<uintptr_t>(p) + static_cast<uintptr_t>(variantDistance);
+    return checkVariant<T>(address, size);
+  }
+
+  // Returns the block of variants at this new address, or null if it's not
+  // entirely in the pool
+  template <typename T>
+  const T* checkVariant(uintptr_t address, size_t size = sizeof(T)) const {
+    if (address < newVariantsBegin || address > newVariantsEnd ||
+        size > newVariantsEnd - address || !isAligned(size_t(address)))
+      return 0;
+    return reinterpret_cast<const T*>(address);
+  }
+
+ private:
+  uintptr_t newAddress(const char* s) const {
+    return reinterpret_cast<uintptr_t>(s) +
+           static_cast<uintptr_t>(stringDistance);
+  }
+};
+
+}  // namespace ARDUINOJSON_NAMESPACE
@@ -38,6 +38,8 @@ class StringBuilder {
     append('\0');
     if (_slot.value) {
       _parent->freezeString(_slot, _size);
+    } else {
+      _parent->discardString();
     }
     return _slot.value;
   }
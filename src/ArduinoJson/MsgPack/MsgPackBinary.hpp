@@ -0,0 +1,72 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#pragma once
+
+#include <stddef.h>  // size_t
+#include <stdint.h>  // uint8_t
+
+namespace ARDUINOJSON_NAMESPACE {
+
+// A MessagePack bin value, i.e., a sequence of bytes.
+// as<MsgPackBinary>() returns a view on the bytes stored in the document, or a
+// null view if the variant is not a binary.
+class MsgPackBinary {
+ public:
+  MsgPackBinary() : _data(0), _size(0) {}
+
+  MsgPackBinary(const void* data, size_t size)
+      : _data(static_cast<const uint8_t*>(data)), _size(size) {}
+
+  const uint8_t* data() const {
+    return _data;
+  }
+
+  size_t size() const {
+    return _size;
+  }
+
+  bool isNull() const {
+    return _data == 0;
+  }
+
+ private:
+  const uint8_t* _data;
+  size_t _size;
+};
+
+// A MessagePack ext value, i.e., a sequence of bytes with an
+// application-defined type.
+// as<MsgPackExtension>() returns a view on the bytes stored in the document, or
+// a null view if the variant is not an extension.
+class MsgPackExtension {
+ public:
+  MsgPackExtension() : _type(0), _data(0), _size(0) {}
+
+  MsgPackExtension(int8_t type, const void* data, size_t size)
+      : _type(type), _data(static_cast<const uint8_t*>(data)), _size(size) {}
+
+  int8_t type() const {
+    return _type;
+  }
+
+  const uint8_t* data() const {
+    return _data;
+  }
+
+  size_t size() const {
+    return _size;
+  }
+
+  bool isNull() const {
+    return _data == 0;
+  }
+
+ private:
+  int8_t _type;
+  const uint8_t* _data;
+  size_t _size;
+};
+
+}  // namespace ARDUINOJSON_NAMESPACE
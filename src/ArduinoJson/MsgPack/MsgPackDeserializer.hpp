@@ -15,25 +15,31 @@ namespace ARDUINOJSON_NAMESPACE {
 
 template <typename TReader, typename TStringStorage>
 class MsgPackDeserializer {
-  typedef typename remove_reference<TStringStorage>::type::StringBuilder
-      StringBuilder;
-
  public:
   MsgPackDeserializer(MemoryPool &pool, TReader reader,
                       TStringStorage stringStorage)
       : _pool(&pool), _reader(reader), _stringStorage(stringStorage) {}
 
-  // TODO: add support for filter
-  DeserializationError parse(VariantData &variant, AllowAllFilter,
+  template <typename TFilter>
+  DeserializationError parse(VariantData &variant, TFilter filter,
                              NestingLimit nestingLimit) {
-    return parse(variant, nestingLimit);
+    return parseVariant(variant, filter, nestingLimit);
   }
 
-  DeserializationError parse(VariantData &variant, NestingLimit nestingLimit) {
-    uint8_t code;
+ private:
+  // Prevent VS warning "assignment operator could not be generated"
+  MsgPackDeserializer &operator=(const MsgPackDeserializer &);
+
+  template <typename TFilter>
+  DeserializationError parseVariant(VariantData &variant, TFilter filter,
+                                    NestingLimit nestingLimit) {
+    uint8_t code = 0;  // <- mute "maybe-uninitialized"
     if (!readByte(code))
       return DeserializationError::IncompleteInput;
 
+    if (!allowed(code, filter))
+      return skipVariant(code, nestingLimit);
+
     if ((code & 0x80) == 0) {
       variant.setUnsignedInteger(code);
       return DeserializationError::Ok;
@@ -50,11 +56,12 @@ class MsgPackDeserializer {
     }
 
     if ((code & 0xf0) == 0x90) {
-      return readArray(variant.toArray(), code & 0x0F, nestingLimit);
+      return readArray(variant.toArray(), code & 0x0F, filter, nestingLimit);
     }
 
     if ((code & 0xf0) == 0x80) {
-      return readObject(variant.toObject(), code & 0x0F, nestingLimit);
+      return readObject(variant.toObject(), code & 0x0F, filter,
+                        nestingLimit);
     }
 
     switch (code) {
@@ -108,6 +115,39 @@ class MsgPackDeserializer {
       case 0xcb:
         return readDouble<double>(variant);
 
+      case 0xc4:
+        return readBinary<uint8_t>(variant);
+
+      case 0xc5:
+        return readBinary<uint16_t>(variant);
+
+      case 0xc6:
+        return readBinary<uint32_t>(variant);
+
+      case 0xc7:
+        return readExtension<uint8_t>(variant);
+
+      case 0xc8:
+        return readExtension<uint16_t>(variant);
+
+      case 0xc9:
+        return readExtension<uint32_t>(variant);
+
+      case 0xd4:
+        return readExtension(variant, 1);
+
+      case 0xd5:
+        return readExtension(variant, 2);
+
+      case 0xd6:
+        return readExtension(variant, 4);
+
+      case 0xd7:
+        return readExtension(variant, 8);
+
+      case 0xd8:
+        return readExtension(variant, 16);
+
       case 0xd9:
         return readString<uint8_t>(variant);
 
@@ -118,25 +158,186 @@ class MsgPackDeserializer {
         return readString<uint32_t>(variant);
 
       case 0xdc:
-        return readArray<uint16_t>(variant.toArray(), nestingLimit);
+        return readArray<uint16_t>(variant.toArray(), filter, nestingLimit);
 
       case 0xdd:
-        return readArray<uint32_t>(variant.toArray(), nestingLimit);
+        return readArray<uint32_t>(variant.toArray(), filter, nestingLimit);
 
       case 0xde:
-        return readObject<uint16_t>(variant.toObject(), nestingLimit);
+        return readObject<uint16_t>(variant.toObject(), filter, nestingLimit);
 
       case 0xdf:
-        return readObject<uint32_t>(variant.toObject(), nestingLimit);
+        return readObject<uint32_t>(variant.toObject(), filter, nestingLimit);
 
       default:
         return DeserializationError::NotSupported;
     }
   }
 
- private:
-  // Prevent VS warning "assignment operator could not be generated"
-  MsgPackDeserializer &operator=(const MsgPackDeserializer &);
+  static bool isArray(uint8_t code) {
+    return (code & 0xf0) == 0x90 || code == 0xdc || code == 0xdd;
+  }
+
+  static bool isObject(uint8_t code) {
+    return (code & 0xf0) == 0x80 || code == 0xde || code == 0xdf;
+  }
+
+  template <typename TFilter>
+  static bool allowed(uint8_t code, TFilter filter) {
+    if (isArray(code))
+      return filter.allowArray();
+    if (isObject(code))
+      return filter.allowObject();
+    return filter.allowValue();
+  }
+
+  DeserializationError skipVariant(NestingLimit nestingLimit) {
+    uint8_t code;
+    if (!readByte(code))
+      return DeserializationError::IncompleteInput;
+    return skipVariant(code, nestingLimit);
+  }
+
+  // Skips the value without allocating
+  DeserializationError skipVariant(uint8_t code, NestingLimit nestingLimit) {
+    if ((code & 0x80) == 0 || (code & 0xe0) == 0xe0)
+      return DeserializationError::Ok;
+
+    if ((code & 0xe0) == 0xa0)
+      return skipBytes(code & 0x1f);
+
+    if ((code & 0xf0) == 0x90)
+      return skipCollection(code & 0x0F, 1, nestingLimit);
+
+    if ((code & 0xf0) == 0x80)
+      return skipCollection(code & 0x0F, 2, nestingLimit);
+
+    switch (code) {
+      case 0xc0:
+      case 0xc2:
+      case 0xc3:
+        return DeserializationError::Ok;
+
+      case 0xcc:
+      case 0xd0:
+        return skipBytes(1);
+
+      case 0xcd:
+      case 0xd1:
+      case 0xd4:  // fixext 1 (type + data)
+        return skipBytes(2);
+
+      case 0xd5:  // fixext 2
+        return skipBytes(3);
+
+      case 0xca:
+      case 0xce:
+      case 0xd2:
+        return skipBytes(4);
+
+      case 0xd6:  // fixext 4
+        return skipBytes(5);
+
+      case 0xcb:
+      case 0xcf:
+      case 0xd3:
+        return skipBytes(8);
+
+      case 0xd7:  // fixext 8
+        return skipBytes(9);
+
+      case 0xd8:  // fixext 16
+        return skipBytes(17);
+
+      case 0xc4:  // bin 8
+      case 0xd9:  // str 8
+        return skipBytes<uint8_t>(0);
+
+      case 0xc5:
+      case 0xda:
+        return skipBytes<uint16_t>(0);
+
+      case 0xc6:
+      case 0xdb:
+        return skipBytes<uint32_t>(0);
+
+      case 0xc7:  // ext 8 (size, type, data)
+        return skipBytes<uint8_t>(1);
+
+      case 0xc8:
+        return skipBytes<uint16_t>(1);
+
+      case 0xc9:
+        return skipBytes<uint32_t>(1);
+
+      case 0xdc:
+        return skipCollection<uint16_t>(1, nestingLimit);
+
+      case 0xdd:
+        return skipCollection<uint32_t>(1, nestingLimit);
+
+      case 0xde:
+        return skipCollection<uint16_t>(2, nestingLimit);
+
+      case 0xdf:
+        return skipCollection<uint32_t>(2, nestingLimit);
+
+      default:
+        return DeserializationError::NotSupported;
+    }
+  }
+
+  // Skips a size of type TSize, then the same number of bytes, plus extra.
+  // Two steps, because size + extra may wrap around on a 32-bit size_t.
+  template <typename TSize>
+  DeserializationError skipBytes(size_t extra) {
+    TSize size;
+    if (!readInteger(size))
+      return DeserializationError::IncompleteInput;
+    DeserializationError err = skipBytes(size);
+    if (err)
+      return err;
+    return skipBytes(extra);
+  }
+
+  DeserializationError skipBytes(size_t n) {
+    char buffer[32];
+    while (n > 0) {
+      size_t chunk = n < sizeof(buffer) ? n : sizeof(buffer);
+      if (_reader.readBytes(buffer, chunk) != chunk)
+        return DeserializationError::IncompleteInput;
+      n -= chunk;
+    }
+    return DeserializationError::Ok;
+  }
+
+  // Skips a count of type TSize, then count * valuesPerItem values
+  template <typename TSize>
+  DeserializationError skipCollection(size_t valuesPerItem,
+                                      NestingLimit nestingLimit) {
+    TSize size;
+    if (!readInteger(size))
+      return DeserializationError::IncompleteInput;
+    return skipCollection(size, valuesPerItem, nestingLimit);
+  }
+
+  // Loops instead of multiplying, because count * valuesPerItem may wrap
+  // around on a 32-bit size_t
+  DeserializationError skipCollection(size_t count, size_t valuesPerItem,
+                                      NestingLimit nestingLimit) {
+    if (nestingLimit.reached())
+      return DeserializationError::TooDeep;
+
+    for (; count; --count) {
+      for (size_t i = 0; i < valuesPerItem; i++) {
+        DeserializationError err = skipVariant(nestingLimit.decrement());
+        if (err)
+          return err;
+      }
+    }
+
+    return DeserializationError::Ok;
+  }
 
   bool readByte(uint8_t &value) {
     int c = _reader.read();
@@ -235,45 +436,94 @@ class MsgPackDeserializer {
   DeserializationError readString(VariantData &variant, size_t n) {
     const char *s = 0;  // <- mute "maybe-uninitialized" (+4 bytes on AVR)
     DeserializationError err = readString(s, n);
-    if (!err)
+    if (err)
+      return err;
+    if (variant.setInlineString(s))
+      _stringStorage.reclaim(s);
+    else
       variant.setOwnedString(make_not_null(s));
     return err;
   }
 
+  // The size is known, so the string is allocated at once and read in a
+  // single call. With a writable input (StringMover), the string stays in the
+  // input and only moves back to make room for the terminator.
   DeserializationError readString(const char *&result, size_t n) {
-    StringBuilder builder = _stringStorage.startString();
-    for (; n; --n) {
-      uint8_t c;
-      if (!readBytes(c))
-        return DeserializationError::IncompleteInput;
-      builder.append(static_cast<char>(c));
-    }
-    result = builder.complete();
-    if (!result)
+    char *s = _stringStorage.allocString(n);
+    if (!s)
       return DeserializationError::NoMemory;
+    if (!readBytes(reinterpret_cast<uint8_t *>(s), n))
+      return DeserializationError::IncompleteInput;
+    s[n] = 0;
+    result = s;
     return DeserializationError::Ok;
   }
 
-  template <typename TSize>
-  DeserializationError readArray(CollectionData &array,
+  // Reads the bytes like a string, so they're followed by a terminator
+  template <typename T>
+  DeserializationError readBinary(VariantData &variant) {
+    T size;
+    if (!readInteger(size))
+      return DeserializationError::IncompleteInput;
+    const char *s = 0;  // <- mute "maybe-uninitialized" (+4 bytes on AVR)
+    DeserializationError err = readString(s, size);
+    if (err)
+      return err;
+    variant.setOwnedBinary(s, size);
+    return err;
+  }
+
+  template <typename T>
+  DeserializationError readExtension(VariantData &variant) {
+    T size;
+    if (!readInteger(size))
+      return DeserializationError::IncompleteInput;
+    return readExtension(variant, size);
+  }
+
+  // Reads the type and the n bytes in one call, see setOwnedExtension()
+  DeserializationError readExtension(VariantData &variant, size_t n) {
+    char *s = _stringStorage.allocString(n);
+    if (!s)
+      return DeserializationError::NoMemory;
+    if (!readBytes(reinterpret_cast<uint8_t *>(s), n + 1))
+      return DeserializationError::IncompleteInput;
+    variant.setOwnedExtension(s, n);
+    return DeserializationError::Ok;
+  }
+
+  template <typename TSize, typename TFilter>
+  DeserializationError readArray(CollectionData &array, TFilter filter,
                                  NestingLimit nestingLimit) {
     TSize size;
     if (!readInteger(size))
       return DeserializationError::IncompleteInput;
-    return readArray(array, size, nestingLimit);
+    return readArray(array, size, filter, nestingLimit);
   }
 
+  template <typename TFilter>
   DeserializationError readArray(CollectionData &array, size_t n,
-                                 NestingLimit nestingLimit) {
+                                 TFilter filter, NestingLimit nestingLimit) {
     if (nestingLimit.reached())
       return DeserializationError::TooDeep;
 
-    for (; n; --n) {
-      VariantData *value = array.addElement(_pool);
-      if (!value)
-        return DeserializationError::NoMemory;
+    TFilter memberFilter = filter[0UL];
+
+    if (!memberFilter.allow())
+      return skipCollection(n, 1, nestingLimit);
 
-      DeserializationError err = parse(*value, nestingLimit.decrement());
+    if (n == 0)
+      return DeserializationError::Ok;
+
+    // The size is known, so the elements are allocated at once, and the error
+    // comes before reading them
+    VariantSlot *slot = array.addElements(n, _pool);
+    if (!slot)
+      return DeserializationError::NoMemory;
+
+    for (; slot; slot = slot->next()) {
+      DeserializationError err =
+          parseVariant(*slot->data(), memberFilter, nestingLimit.decrement());
       if (err)
         return err;
     }
@@ -281,32 +531,46 @@ class MsgPackDeserializer {
     return DeserializationError::Ok;
   }
 
-  template <typename TSize>
-  DeserializationError readObject(CollectionData &object,
+  template <typename TSize, typename TFilter>
+  DeserializationError readObject(CollectionData &object, TFilter filter,
                                   NestingLimit nestingLimit) {
     TSize size;
     if (!readInteger(size))
       return DeserializationError::IncompleteInput;
-    return readObject(object, size, nestingLimit);
+    return readObject(object, size, filter, nestingLimit);
   }
 
+  template <typename TFilter>
   DeserializationError readObject(CollectionData &object, size_t n,
-                                  NestingLimit nestingLimit) {
+                                  TFilter filter, NestingLimit nestingLimit) {
     if (nestingLimit.reached())
       return DeserializationError::TooDeep;
 
-    for (; n; --n) {
-      VariantSlot *slot = object.addSlot(_pool);
-      if (!slot)
-        return DeserializationError::NoMemory;
+    if (n && filter.allowValue())  // i.e., all the members are kept
+      return readAllMembers(object, n, filter, nestingLimit);
 
+    for (; n; --n) {
       const char *key = 0;  // <- mute "maybe-uninitialized" (+4 bytes on AVR)
       DeserializationError err = parseKey(key);
       if (err)
         return err;
-      slot->setOwnedKey(make_not_null(key));
 
-      err = parse(*slot->data(), nestingLimit.decrement());
+      TFilter memberFilter = filter[key];
+
+      if (memberFilter.allow()) {
+        VariantSlot *slot = object.addSlot(_pool);
+        if (!slot)
+          return DeserializationError::NoMemory;
+
+        slot->setOwnedKey(make_not_null(_pool->internKey(key)));
+        object.indexMember(slot, _pool);
+
+        err = parseVariant(*slot->data(), memberFilter,
+                           nestingLimit.decrement());
+      } else {
+        _stringStorage.reclaim(key);
+        err = skipVariant(nestingLimit.decrement());
+      }
       if (err)
         return err;
     }
@@ -314,6 +578,39 @@ class MsgPackDeserializer {
     return DeserializationError::Ok;
   }
 
+  // Like readArray(), allocates the n members at once.
+  // On error, it removes the members that didn't receive a key.
+  template <typename TFilter>
+  DeserializationError readAllMembers(CollectionData &object, size_t n,
+                                      TFilter filter,
+                                      NestingLimit nestingLimit) {
+    VariantSlot *slot = object.addSlots(n, _pool);
+    if (!slot)
+      return DeserializationError::NoMemory;
+
+    VariantSlot *last = 0;
+    for (; slot; slot = slot->next()) {
+      const char *key = 0;  // <- mute "maybe-uninitialized" (+4 bytes on AVR)
+      DeserializationError err = parseKey(key);
+      if (err) {
+        object.truncate(last);
+        return err;
+      }
+
+      slot->setOwnedKey(make_not_null(_pool->internKey(key)));
+      object.indexMember(slot, _pool);
+      last = slot;
+
+      err = parseVariant(*slot->data(), filter[key], nestingLimit.decrement());
+      if (err) {
+        object.truncate(last);
+        return err;
+      }
+    }
+
+    return DeserializationError::Ok;
+  }
+
   DeserializationError parseKey(const char *&key) {
     uint8_t code;
     if (!readByte(code))
@@ -342,6 +639,7 @@ class MsgPackDeserializer {
   TStringStorage _stringStorage;
 };
 
+// deserializeMsgPack(JsonDocument&, const std::string&, ...)
 template <typename TInput>
 DeserializationError deserializeMsgPack(
     JsonDocument &doc, const TInput &input,
@@ -349,7 +647,20 @@ DeserializationError deserializeMsgPack(
   return deserialize<MsgPackDeserializer>(doc, input, nestingLimit,
                                           AllowAllFilter());
 }
+template <typename TInput>
+DeserializationError deserializeMsgPack(
+    JsonDocument &doc, const TInput &input, Filter filter,
+    NestingLimit nestingLimit = NestingLimit()) {
+  return deserialize<MsgPackDeserializer>(doc, input, nestingLimit, filter);
+}
+template <typename TInput>
+DeserializationError deserializeMsgPack(JsonDocument &doc, const TInput &input,
+                                        NestingLimit nestingLimit,
+                                        Filter filter) {
+  return deserialize<MsgPackDeserializer>(doc, input, nestingLimit, filter);
+}
 
+// deserializeMsgPack(JsonDocument&, char*, ...)
 template <typename TInput>
 DeserializationError deserializeMsgPack(
     JsonDocument &doc, TInput *input,
@@ -357,7 +668,20 @@ DeserializationError deserializeMsgPack(
   return deserialize<MsgPackDeserializer>(doc, input, nestingLimit,
                                           AllowAllFilter());
 }
+template <typename TInput>
+DeserializationError deserializeMsgPack(
+    JsonDocument &doc, TInput *input, Filter filter,
+    NestingLimit nestingLimit = NestingLimit()) {
+  return deserialize<MsgPackDeserializer>(doc, input, nestingLimit, filter);
+}
+template <typename TInput>
+DeserializationError deserializeMsgPack(JsonDocument &doc, TInput *input,
+                                        NestingLimit nestingLimit,
+                                        Filter filter) {
+  return deserialize<MsgPackDeserializer>(doc, input, nestingLimit, filter);
+}
 
+// deserializeMsgPack(JsonDocument&, char*, size_t, ...)
 template <typename TInput>
 DeserializationError deserializeMsgPack(
     JsonDocument &doc, TInput *input, size_t inputSize,
@@ -365,7 +689,23 @@ DeserializationError deserializeMsgPack(
   return deserialize<MsgPackDeserializer>(doc, input, inputSize, nestingLimit,
                                           AllowAllFilter());
 }
+template <typename TInput>
+DeserializationError deserializeMsgPack(
+    JsonDocument &doc, TInput *input, size_t inputSize, Filter filter,
+    NestingLimit nestingLimit = NestingLimit()) {
+  return deserialize<MsgPackDeserializer>(doc, input, inputSize, nestingLimit,
+                                          filter);
+}
+template <typename TInput>
+DeserializationError deserializeMsgPack(JsonDocument &doc, TInput *input,
+                                        size_t inputSize,
+                                        NestingLimit nestingLimit,
+                                        Filter filter) {
+  return deserialize<MsgPackDeserializer>(doc, input, inputSize, nestingLimit,
+                                          filter);
+}
 
+// deserializeMsgPack(JsonDocument&, std::istream&, ...)
 template <typename TInput>
 DeserializationError deserializeMsgPack(
     JsonDocument &doc, TInput &input,
@@ -373,4 +713,17 @@ DeserializationError deserializeMsgPack(
   return deserialize<MsgPackDeserializer>(doc, input, nestingLimit,
                                           AllowAllFilter());
 }
+template <typename TInput>
+DeserializationError deserializeMsgPack(
+    JsonDocument &doc, TInput &input, Filter filter,
+    NestingLimit nestingLimit = NestingLimit()) {
+  return deserialize<MsgPackDeserializer>(doc, input, nestingLimit, filter);
+}
+template <typename TInput>
+DeserializationError deserializeMsgPack(JsonDocument &doc, TInput &input,
+                                        NestingLimit nestingLimit,
+                                        Filter filter) {
+  return deserialize<MsgPackDeserializer>(doc, input, nestingLimit, filter);
+}
+
 }  // namespace ARDUINOJSON_NAMESPACE
@@ -7,6 +7,7 @@
 #include <ArduinoJson/MsgPack/endianess.hpp>
 #include <ArduinoJson/Polyfills/assert.hpp>
 #include <ArduinoJson/Polyfills/type_traits.hpp>
+#include <ArduinoJson/Serialization/ResumableSerializer.hpp>
 #include <ArduinoJson/Serialization/measure.hpp>
 #include <ArduinoJson/Serialization/serialize.hpp>
 #include <ArduinoJson/Variant/VariantData.hpp>
@@ -16,7 +17,7 @@ namespace ARDUINOJSON_NAMESPACE {
 template <typename TWriter>
 class MsgPackSerializer {
  public:
-  MsgPackSerializer(TWriter writer) : _writer(writer), _bytesWritten(0) {}
+  MsgPackSerializer(TWriter &writer) : _writer(writer), _bytesWritten(0) {}
 
   template <typename T>
   typename enable_if<sizeof(T) == 4>::type visitFloat(T value32) {
@@ -38,9 +39,24 @@ class MsgPackSerializer {
   }
 
   void visitArray(const CollectionData& array) {
-    size_t n = array.size();
+    writeArrayHeader(array.size());
+    for (VariantSlot* slot = array.head(); slot; slot = slot->next()) {
+      slot->data()->accept(*this);
+    }
+  }
+
+  void visitObject(const CollectionData& object) {
+    writeObjectHeader(object.size());
+    for (VariantSlot* slot = object.head(); slot; slot = slot->next()) {
+      visitString(slot->key());
+      slot->data()->accept(*this);
+    }
+  }
+
+  // Writes the header of an array of n elements
+  void writeArrayHeader(size_t n) {
     if (n < 0x10) {
-      writeByte(uint8_t(0x90 + array.size()));
+      writeByte(uint8_t(0x90 + n));
     } else if (n < 0x10000) {
       writeByte(0xDC);
       writeInteger(uint16_t(n));
@@ -48,13 +64,10 @@ class MsgPackSerializer {
       writeByte(0xDD);
       writeInteger(uint32_t(n));
     }
-    for (VariantSlot* slot = array.head(); slot; slot = slot->next()) {
-      slot->data()->accept(*this);
-    }
   }
 
-  void visitObject(const CollectionData& object) {
-    size_t n = object.size();
+  // Writes the header of an object of n members
+  void writeObjectHeader(size_t n) {
     if (n < 0x10) {
       writeByte(uint8_t(0x80 + n));
     } else if (n < 0x10000) {
@@ -64,17 +77,70 @@ class MsgPackSerializer {
       writeByte(0xDF);
       writeInteger(uint32_t(n));
     }
-    for (VariantSlot* slot = object.head(); slot; slot = slot->next()) {
-      visitString(slot->key());
-      slot->data()->accept(*this);
-    }
+  }
+
+  // The tokens of visitArray() and visitObject(), for ResumableSerializer
+
+  void beginArray(const CollectionData& array) {
+    writeArrayHeader(array.size());
+  }
+
+  void beginObject(const CollectionData& object) {
+    writeObjectHeader(object.size());
+  }
+
+  void endArray() {}
+
+  void endObject() {}
+
+  void writeKey(const char* key) {
+    visitString(key);
+  }
+
+  void writeSeparator() {}
+
+  // The parts of visitString(), visitRawJson(), visitBinary(), and
+  // visitExtension(), for ResumableSerializer
+
+  void beginString(size_t n) {
+    writeStringHeader(n);
+  }
+
+  void writeStringPart(const char* s, size_t n) {
+    writeBytes(reinterpret_cast<const uint8_t*>(s), n);
+  }
+
+  void endString() {}
+
+  void writeKeySeparator() {}
+
+  void writeRawPart(const char* s, size_t n) {
+    writeBytes(reinterpret_cast<const uint8_t*>(s), n);
+  }
+
+  void beginBinary(size_t n) {
+    writeBinaryHeader(n);
+  }
+
+  // the part after the header includes the type
+  void beginExtension(size_t n) {
+    writeExtensionHeader(n);
+  }
+
+  void writeBinaryPart(const char* s, size_t n) {
+    writeBytes(reinterpret_cast<const uint8_t*>(s), n);
   }
 
   void visitString(const char* value) {
     ARDUINOJSON_ASSERT(value != NULL);
 
     size_t n = strlen(value);
+    writeStringHeader(n);
+    writeBytes(reinterpret_cast<const uint8_t*>(value), n);
+  }
 
+  // Writes the header of a string of n bytes
+  void writeStringHeader(size_t n) {
     if (n < 0x20) {
       writeByte(uint8_t(0xA0 + n));
     } else if (n < 0x100) {
@@ -87,13 +153,70 @@ class MsgPackSerializer {
       writeByte(0xDB);
       writeInteger(uint32_t(n));
     }
-    writeBytes(reinterpret_cast<const uint8_t*>(value), n);
   }
 
   void visitRawJson(const char* data, size_t size) {
     writeBytes(reinterpret_cast<const uint8_t*>(data), size);
   }
 
+  void visitBinary(const char* data, size_t size) {
+    writeBinaryHeader(size);
+    writeBytes(reinterpret_cast<const uint8_t*>(data), size);
+  }
+
+  // data points to the type, followed by size bytes
+  void visitExtension(const char* data, size_t size) {
+    writeExtensionHeader(size);
+    writeBytes(reinterpret_cast<const uint8_t*>(data), size + 1);
+  }
+
+  // Writes the header of a bin of n bytes
+  void writeBinaryHeader(size_t n) {
+    if (n < 0x100) {
+      writeByte(0xC4);
+      writeInteger(uint8_t(n));
+    } else if (n < 0x10000) {
+      writeByte(0xC5);
+      writeInteger(uint16_t(n));
+    } else {
+      writeByte(0xC6);
+      writeInteger(uint32_t(n));
+    }
+  }
+
+  // Writes the header of an ext of n bytes, except the type
+  void writeExtensionHeader(size_t n) {
+    switch (n) {
+      case 1:
+        writeByte(0xD4);
+        break;
+      case 2:
+        writeByte(0xD5);
+        break;
+      case 4:
+        writeByte(0xD6);
+        break;
+      case 8:
+        writeByte(0xD7);
+        break;
+      case 16:
+        writeByte(0xD8);
+        break;
+      default:
+        if (n < 0x100) {
+          writeByte(0xC7);
+          writeInteger(uint8_t(n));
+        } else if (n < 0x10000) {
+          writeByte(0xC8);
+          writeInteger(uint16_t(n));
+        } else {
+          writeByte(0xC9);
+          writeInteger(uint32_t(n));
+        }
+        break;
+    }
+  }
+
   void visitNegativeInteger(UInt value) {
     UInt negated = UInt(~value + 1);
     if (value <= 0x20) {
@@ -170,10 +293,12 @@ class MsgPackSerializer {
     writeBytes(reinterpret_cast<uint8_t*>(&value), sizeof(value));
   }
 
-  TWriter _writer;
+  TWriter &_writer;
   size_t _bytesWritten;
 };
 
+typedef ResumableSerializer<MsgPackSerializer> ResumableMsgPackSerializer;
+
 template <typename TSource, typename TDestination>
 inline size_t serializeMsgPack(const TSource& source, TDestination& output) {
   return serialize<MsgPackSerializer>(source, output);
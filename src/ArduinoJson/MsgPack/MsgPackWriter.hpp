@@ -0,0 +1,243 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Misc/SerializedValue.hpp>
+#include <ArduinoJson/MsgPack/MsgPackBinary.hpp>
+#include <ArduinoJson/MsgPack/MsgPackSerializer.hpp>
+#include <ArduinoJson/Numbers/Float.hpp>
+#include <ArduinoJson/Numbers/Integer.hpp>
+#include <ArduinoJson/Polyfills/type_traits.hpp>
+#include <ArduinoJson/Serialization/Writer.hpp>
+
+#include <stdint.h>  // uint64_t
+
+namespace ARDUINOJSON_NAMESPACE {
+
+// Writes MessagePack directly to the destination, without a JsonDocument.
+// Unlike JsonWriter, the size of the arrays and objects must be known in
+// advance, because MessagePack writes it before the content.
+//
+//   MsgPackWriter<std::string> msgpack(output);
+//   msgpack.beginObject(1);
+//   msgpack.key("values");
+//   msgpack.beginArray(1);
+//   msgpack.value(42);
+//   msgpack.end();
+//   msgpack.end();
+//
+// The functions return false, and write nothing, when they're called at the
+// wrong place (for example, more values than announced, or end() before the
+// last one), when the nesting exceeds ARDUINOJSON_DEFAULT_NESTING_LIMIT, or
+// when a count or a size doesn't fit in the 32 bits of a MessagePack header.
+// CAUTION: some writers buffer the output (std::string, String, std::ostream),
+// so the output is complete only when the MsgPackWriter is destroyed.
+template <typename TDestination>
+class MsgPackWriter {
+  static const size_t maxDepth = ARDUINOJSON_DEFAULT_NESTING_LIMIT;
+
+ public:
+  explicit MsgPackWriter(TDestination &destination)
+      : _writer(destination),
+        _serializer(_writer),
+        _depth(0),
+        _afterKey(false),
+        _complete(false) {}
+
+  // Begins an array of n elements
+  bool beginArray(size_t n) {
+    if (_depth >= maxDepth || !fitsInHeader(n) || !beginValue())
+      return false;
+    _serializer.writeArrayHeader(n);
+    push(n, false);
+    return true;
+  }
+
+  // Begins an object of n members
+  bool beginObject(size_t n) {
+    if (_depth >= maxDepth || !fitsInHeader(n) || !beginValue())
+      return false;
+    _serializer.writeObjectHeader(n);
+    push(n, true);
+    return true;
+  }
+
+  // Closes the current array or object, once all its values are written
+  bool end() {
+    if (_depth == 0 || _remaining[_depth - 1] > 0)
+      return false;
+    _depth--;
+    return endValue();
+  }
+
+  bool key(const char *s) {
+    if (!s || _depth == 0 || !_isObject[_depth - 1] || _afterKey ||
+        _remaining[_depth - 1] == 0)
+      return false;
+    _serializer.visitString(s);
+    _afterKey = true;
+    return true;
+  }
+
+#if ARDUINOJSON_ENABLE_STD_STRING
+  bool key(const std::string &s) {
+    return key(s.c_str());
+  }
+#endif
+
+#if ARDUINOJSON_ENABLE_ARDUINO_STRING
+  bool key(const ::String &s) {
+    return key(s.c_str());
+  }
+#endif
+
+  // Writes a string, or nil if s is null
+  bool value(const char *s) {
+    if (!beginValue())
+      return false;
+    if (s)
+      _serializer.visitString(s);
+    else
+      _serializer.visitNull();
+    return endValue();
+  }
+
+#if ARDUINOJSON_ENABLE_STD_STRING
+  bool value(const std::string &s) {
+    return value(s.c_str());
+  }
+#endif
+
+#if ARDUINOJSON_ENABLE_ARDUINO_STRING
+  bool value(const ::String &s) {
+    return value(s.c_str());
+  }
+#endif
+
+  bool value(bool b) {
+    if (!beginValue())
+      return false;
+    _serializer.visitBoolean(b);
+    return endValue();
+  }
+
+  template <typename T>
+  typename enable_if<is_integral<T>::value && is_signed<T>::value, bool>::type
+  value(T n) {
+    if (!beginValue())
+      return false;
+    if (n >= 0)
+      _serializer.visitPositiveInteger(static_cast<UInt>(n));
+    else
+      _serializer.visitNegativeInteger(~static_cast<UInt>(n) + 1);
+    return endValue();
+  }
+
+  template <typename T>
+  typename enable_if<is_integral<T>::value && is_unsigned<T>::value, bool>::type
+  value(T n) {
+    if (!beginValue())
+      return false;
+    _serializer.visitPositiveInteger(static_cast<UInt>(n));
+    return endValue();
+  }
+
+  template <typename T>
+  typename enable_if<is_floating_point<T>::value, bool>::type value(T n) {
+    if (!beginValue())
+      return false;
+    _serializer.visitFloat(static_cast<Float>(n));
+    return endValue();
+  }
+
+  // Writes pregenerated MessagePack, see serialized()
+  template <typename T>
+  bool value(SerializedValue<T> raw) {
+    if (!beginValue())
+      return false;
+    _serializer.visitRawJson(raw.data(), raw.size());
+    return endValue();
+  }
+
+  bool value(MsgPackBinary bin) {
+    if (!fitsInHeader(bin.size()) || !beginValue())
+      return false;
+    _serializer.writeBinaryHeader(bin.size());
+    _serializer.visitRawJson(reinterpret_cast<const char *>(bin.data()),
+                             bin.size());
+    return endValue();
+  }
+
+  bool value(MsgPackExtension ext) {
+    if (!fitsInHeader(ext.size()) || !beginValue())
+      return false;
+    char type = static_cast<char>(ext.type());
+    _serializer.writeExtensionHeader(ext.size());
+    _serializer.visitRawJson(&type, 1);
+    _serializer.visitRawJson(reinterpret_cast<const char *>(ext.data()),
+                             ext.size());
+    return endValue();
+  }
+
+  bool null() {
+    if (!beginValue())
+      return false;
+    _serializer.visitNull();
+    return endValue();
+  }
+
+  // Tells if the root value is completely written
+  bool complete() const {
+    return _complete;
+  }
+
+  size_t bytesWritten() const {
+    return _serializer.bytesWritten();
+  }
+
+ private:
+  MsgPackWriter(const MsgPackWriter &);  // non-copyable, see TextFormatter
+  MsgPackWriter &operator=(const MsgPackWriter &);
+
+  static bool fitsInHeader(size_t n) {
+    return static_cast<uint64_t>(n) <= 0xFFFFFFFF;
+  }
+
+  void push(size_t n, bool isObject) {
+    _remaining[_depth] = n;
+    _isObject[_depth] = isObject;
+    _depth++;
+    _afterKey = false;
+  }
+
+  // Checks that a value is expected
+  bool beginValue() const {
+    if (_depth == 0)
+      return !_complete;
+    if (_isObject[_depth - 1])
+      return _afterKey;
+    return _remaining[_depth - 1] > 0;
+  }
+
+  // Counts the value in its parent (a collection counts after end())
+  bool endValue() {
+    if (_depth == 0)
+      _complete = true;
+    else
+      _remaining[_depth - 1]--;
+    _afterKey = false;
+    return true;
+  }
+
+  Writer<TDestination> _writer;
+  MsgPackSerializer<Writer<TDestination> > _serializer;
+  size_t _remaining[maxDepth];
+  bool _isObject[maxDepth];
+  size_t _depth;
+  bool _afterKey;
+  bool _complete;
+};
+
+}  // namespace ARDUINOJSON_NAMESPACE
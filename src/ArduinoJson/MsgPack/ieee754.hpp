@@ -15,4 +15,63 @@ inline void doubleToFloat(const uint8_t d[8], uint8_t f[4]) {
   f[3] = uint8_t((d[3] << 3) | (d[4] >> 5));
 }
 
+// Converts a big-endian half-precision float (as in CBOR) to a big-endian float
+inline void halfToFloat(const uint8_t h[2], uint8_t f[4]) {
+  uint32_t sign = uint32_t(h[0] & 0x80) << 24;
+  uint32_t exponent = uint32_t(h[0] >> 2 & 0x1f);
+  uint32_t mantissa = uint32_t((h[0] & 0x03) << 8 | h[1]);
+  uint32_t bits;
+  if (exponent == 0x1f) {  // infinity or NaN
+    bits = sign | 0x7f800000 | mantissa << 13;
+  } else if (exponent) {
+    bits = sign | (exponent + 112) << 23 | mantissa << 13;
+  } else if (!mantissa) {
+    bits = sign;
+  } else {  // subnormal halfs are normal floats
+    exponent = 113;
+    while (!(mantissa & 0x400)) {
+      mantissa <<= 1;
+      exponent--;
+    }
+    bits = sign | exponent << 23 | (mantissa & 0x3ff) << 13;
+  }
+  f[0] = uint8_t(bits >> 24);
+  f[1] = uint8_t(bits >> 16);
+  f[2] = uint8_t(bits >> 8);
+  f[3] = uint8_t(bits);
+}
+
+// Converts the bits of a float to a half-precision float.
+// Returns false if the value can't be represented exactly.
+inline bool floatToHalf(uint32_t f, uint16_t &h) {
+  uint16_t sign = uint16_t(f >> 16 & 0x8000);
+  int exponent = int(f >> 23 & 0xff) - 127;
+  uint32_t mantissa = f & 0x7fffff;
+  if (exponent == 128) {  // infinity or NaN
+    if (mantissa & 0x1fff)
+      return false;
+    h = uint16_t(sign | 0x7c00 | mantissa >> 13);
+    return true;
+  }
+  if (exponent == -127 && !mantissa) {
+    h = sign;
+    return true;
+  }
+  if (exponent >= -14 && exponent <= 15) {
+    if (mantissa & 0x1fff)
+      return false;
+    h = uint16_t(sign | (exponent + 15) << 10 | mantissa >> 13);
+    return true;
+  }
+  if (exponent >= -24 && exponent < -14) {  // subnormal half
+    uint32_t shift = uint32_t(-1 - exponent);
+    mantissa |= 0x800000;
+    if (mantissa & ((uint32_t(1) << shift) - 1))
+      return false;
+    h = uint16_t(sign | mantissa >> shift);
+    return true;
+  }
+  return false;
+}
+
 }  // namespace ARDUINOJSON_NAMESPACE
@@ -27,10 +27,10 @@ class PairPtr {
 
 class ObjectIterator {
  public:
-  ObjectIterator() : _slot(0) {}
+  ObjectIterator() : _slot(0), _prev(0) {}
 
   explicit ObjectIterator(MemoryPool *pool, VariantSlot *slot)
-      : _pool(pool), _slot(slot) {}
+      : _pool(pool), _slot(slot), _prev(0) {}
 
   Pair operator*() const {
     return Pair(_pool, _slot);
@@ -48,12 +48,15 @@ class ObjectIterator {
   }
 
   ObjectIterator &operator++() {
+    // keep the previous slot if the current one was removed
+    if (!_prev || _prev->next() == _slot)
+      _prev = _slot;
     _slot = _slot->next();
     return *this;
   }
 
   ObjectIterator &operator+=(size_t distance) {
-    _slot = _slot->next(distance);
+    while (distance-- && _slot) operator++();
     return *this;
   }
 
@@ -61,9 +64,15 @@ class ObjectIterator {
     return _slot;
   }
 
+  // The slot before internal(), or null at the beginning
+  VariantSlot *previous() {
+    return _prev;
+  }
+
  private:
   MemoryPool *_pool;
   VariantSlot *_slot;
+  VariantSlot *_prev;
 };
 
 class PairConstPtr {
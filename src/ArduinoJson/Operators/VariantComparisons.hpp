@@ -32,6 +32,8 @@ struct Comparer<T, typename enable_if<IsString<T>::value>::type> {
     result = -adaptString(rhs).compare(lhs);
   }
   void visitRawJson(const char *, size_t) {}
+  void visitBinary(const char *, size_t) {}
+  void visitExtension(const char *, size_t) {}
   void visitNegativeInteger(UInt) {}
   void visitPositiveInteger(UInt) {}
   void visitBoolean(bool) {}
@@ -65,6 +67,8 @@ struct Comparer<T, typename enable_if<is_integral<T>::value ||
   }
   void visitString(const char *) {}
   void visitRawJson(const char *, size_t) {}
+  void visitBinary(const char *, size_t) {}
+  void visitExtension(const char *, size_t) {}
   void visitNegativeInteger(UInt lhs) {
     result = -sign(static_cast<T>(lhs) + rhs);
   }
@@ -87,6 +91,8 @@ struct Comparer<bool, void> {
   void visitFloat(Float) {}
   void visitString(const char *) {}
   void visitRawJson(const char *, size_t) {}
+  void visitBinary(const char *, size_t) {}
+  void visitExtension(const char *, size_t) {}
   void visitNegativeInteger(UInt) {}
   void visitPositiveInteger(UInt) {}
   void visitBoolean(bool lhs) {
@@ -107,6 +113,8 @@ struct Comparer<decltype(nullptr), void> {
   void visitFloat(Float) {}
   void visitString(const char *) {}
   void visitRawJson(const char *, size_t) {}
+  void visitBinary(const char *, size_t) {}
+  void visitExtension(const char *, size_t) {}
   void visitNegativeInteger(UInt) {}
   void visitPositiveInteger(UInt) {}
   void visitBoolean(bool) {}
@@ -0,0 +1,516 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Configuration.hpp>
+#include <ArduinoJson/Serialization/Writer.hpp>
+#include <ArduinoJson/Serialization/Writers/DummyWriter.hpp>
+#include <ArduinoJson/Variant/VariantSlot.hpp>
+
+#include <string.h>  // memcpy, strlen
+
+namespace ARDUINOJSON_NAMESPACE {
+
+// Serializes a document in chunks of the size of the caller's buffer, for
+// example to write to a non-blocking socket as it drains:
+//
+//   ResumableJsonSerializer serializer(doc);
+//   while (!serializer.done()) {
+//     size_t n = serializer.next(buffer, sizeof(buffer));
+//     ...
+//   }
+//
+// Instead of recursing, it keeps an explicit stack of the collections.
+// It writes the strings, the raw values, and the binary values in slices of
+// the size of the room left in the buffer. When a slice doesn't fit, it
+// resumes after the last character that was completely written, skipping the
+// part of its escape sequence that was already returned. Any other token, like
+// a number, resumes by writing it again and skipping the bytes that were
+// already returned. Therefore, each call costs about twice the size of its
+// output, whatever the length of the strings and the size of the previous
+// buffers.
+// The stack holds ARDUINOJSON_DEFAULT_NESTING_LIMIT collections; a deeper
+// document stops with failed() and a truncated output, even if it's valid.
+// Define ARDUINOJSON_DEFAULT_NESTING_LIMIT to support deeper documents.
+// CAUTION: the document must not change until the serialization is done.
+template <template <typename> class TSerializer>
+class ResumableSerializer {
+  static const size_t maxDepth = ARDUINOJSON_DEFAULT_NESTING_LIMIT;
+
+  // Writes the tokens in the caller's buffer
+  class Chunk {
+   public:
+    Chunk() : _ptr(0), _end(0), _skip(0), _tokenSize(0), _overflowed(false) {}
+
+    void reset(uint8_t *buffer, size_t size) {
+      _ptr = buffer;
+      _end = buffer + size;
+    }
+
+    // Starts a token, whose first bytes were already returned
+    void beginToken(size_t skip) {
+      _skip = skip;
+      _tokenSize = 0;
+      _overflowed = false;
+    }
+
+    // Tells that the token that overflowed will restart at a later point,
+    // of which `written` bytes were already returned
+    void restartToken(size_t written) {
+      _tokenSize = written;
+    }
+
+    size_t write(uint8_t c) {
+      return write(&c, 1);
+    }
+
+    size_t write(const uint8_t *s, size_t n) {
+      if (_overflowed)
+        return 0;
+      size_t skipped = n < _skip ? n : _skip;
+      _skip -= skipped;
+      s += skipped;
+      n -= skipped;
+      if (n > room()) {
+        n = room();
+        _overflowed = true;
+      }
+      if (n) {
+        memcpy(_ptr, s, n);
+        _ptr += n;
+      }
+      _tokenSize += skipped + n;
+      return skipped + n;
+    }
+
+    size_t room() const {
+      return size_t(_end - _ptr);
+    }
+
+    uint8_t *ptr() const {
+      return _ptr;
+    }
+
+    // Number of bytes of the current token, including the skipped ones
+    size_t tokenSize() const {
+      return _tokenSize;
+    }
+
+    bool overflowed() const {
+      return _overflowed;
+    }
+
+   private:
+    uint8_t *_ptr;
+    uint8_t *_end;
+    size_t _skip;
+    size_t _tokenSize;
+    bool _overflowed;
+  };
+
+  // Records the root value, see the constructor
+  class RootCapture {
+   public:
+    RootCapture(ResumableSerializer *parent) : _parent(parent) {}
+
+    void visitArray(const CollectionData &array) {
+      _parent->_rootCollection = &array;
+      _parent->_rootIsObject = false;
+    }
+
+    void visitObject(const CollectionData &object) {
+      _parent->_rootCollection = &object;
+      _parent->_rootIsObject = true;
+    }
+
+    void visitFloat(Float value) {
+      _parent->_root.setFloat(value);
+    }
+
+    void visitString(const char *value) {
+      _parent->_root.setLinkedString(value);
+    }
+
+    void visitRawJson(const char *data, size_t n) {
+      _parent->_root.setLinkedRaw(SerializedValue<const char *>(data, n));
+    }
+
+    void visitBinary(const char *data, size_t n) {
+      _parent->_root.setOwnedBinary(data, n);
+    }
+
+    void visitExtension(const char *data, size_t n) {
+      _parent->_root.setOwnedExtension(data, n);
+    }
+
+    void visitNegativeInteger(UInt value) {
+      _parent->_root.setNegativeInteger(value);
+    }
+
+    void visitPositiveInteger(UInt value) {
+      _parent->_root.setPositiveInteger(value);
+    }
+
+    void visitBoolean(bool value) {
+      _parent->_root.setBoolean(value);
+    }
+
+    void visitNull() {
+      _parent->_root.setNull();
+    }
+
+   private:
+    ResumableSerializer *_parent;
+  };
+
+  // Writes a value that isn't a collection.
+  // For a string, a raw value, or a binary value, it only writes the header,
+  // and leaves the rest to writeTextPart().
+  class ValueWriter {
+   public:
+    ValueWriter(ResumableSerializer *parent) : _parent(parent) {}
+
+    void visitArray(const CollectionData &array) {
+      _parent->_serializer.visitArray(array);
+    }
+
+    void visitObject(const CollectionData &object) {
+      _parent->_serializer.visitObject(object);
+    }
+
+    void visitFloat(Float value) {
+      _parent->_serializer.visitFloat(value);
+    }
+
+    void visitString(const char *value) {
+      _parent->beginText(TEXT_STRING, value, strlen(value));
+    }
+
+    void visitRawJson(const char *data, size_t n) {
+      _parent->beginText(TEXT_RAW, data, n);
+    }
+
+    void visitBinary(const char *data, size_t n) {
+      _parent->beginText(TEXT_BINARY, data, n);
+    }
+
+    // data points to the type, followed by n bytes
+    void visitExtension(const char *data, size_t n) {
+      _parent->beginText(TEXT_EXTENSION, data, n);
+    }
+
+    void visitNegativeInteger(UInt value) {
+      _parent->_serializer.visitNegativeInteger(value);
+    }
+
+    void visitPositiveInteger(UInt value) {
+      _parent->_serializer.visitPositiveInteger(value);
+    }
+
+    void visitBoolean(bool value) {
+      _parent->_serializer.visitBoolean(value);
+    }
+
+    void visitNull() {
+      _parent->_serializer.visitNull();
+    }
+
+   private:
+    ResumableSerializer *_parent;
+  };
+
+  enum TextKind {
+    TEXT_NONE,
+    TEXT_KEY,
+    TEXT_STRING,
+    TEXT_RAW,
+    TEXT_BINARY,
+    TEXT_EXTENSION
+  };
+
+  // The string, raw value, or binary value being written
+  struct Text {
+    TextKind kind;
+    const char *data;
+    size_t size;
+    size_t offset;  // of the next slice
+  };
+
+  struct Frame {
+    const VariantSlot *slot;
+    bool isObject;
+  };
+
+  enum Step {
+    STEP_ROOT,
+    STEP_KEY,
+    STEP_VALUE,
+    STEP_TEXT,      // the slices of a string, raw, or binary value
+    STEP_TEXT_END,  // after the last slice
+    STEP_NEXT,      // after a value
+    STEP_END,
+    STEP_DONE
+  };
+
+ public:
+  template <typename TSource>
+  explicit ResumableSerializer(const TSource &source)
+      : _writer(_chunk),
+        _serializer(_writer),
+        _root(),
+        _rootCollection(0),
+        _rootIsObject(false),
+        _depth(0),
+        _step(STEP_ROOT),
+        _tokenOffset(0),
+        _failed(false) {
+    _text.kind = TEXT_NONE;
+    RootCapture capture(this);
+    source.accept(capture);
+  }
+
+  // Writes the next part of the output in the buffer.
+  // Returns the number of bytes written, 0 once done() is true.
+  size_t next(void *buffer, size_t bufferSize) {
+    uint8_t *begin = reinterpret_cast<uint8_t *>(buffer);
+    _chunk.reset(begin, bufferSize);
+    // continue when the buffer is full, in case the next tokens are empty
+    while (_step != STEP_DONE) {
+      _chunk.beginToken(_tokenOffset);
+      Step step = writeToken();
+      if (_chunk.overflowed()) {
+        _tokenOffset = _chunk.tokenSize();
+        break;
+      }
+      _tokenOffset = 0;
+      _step = step;
+    }
+    return size_t(_chunk.ptr() - begin);
+  }
+
+  // Tells if the whole document has been written
+  bool done() const {
+    return _step == STEP_DONE;
+  }
+
+  // Tells if the serialization stopped because the document is nested deeper
+  // than ARDUINOJSON_DEFAULT_NESTING_LIMIT
+  bool failed() const {
+    return _failed;
+  }
+
+ private:
+  ResumableSerializer(const ResumableSerializer &);
+  ResumableSerializer &operator=(const ResumableSerializer &);
+
+  // Writes one token, and returns the following step.
+  // The state only changes when the token is complete, so that it can be
+  // written again; except for the slices of a text, see writeTextPart().
+  Step writeToken() {
+    switch (_step) {
+      case STEP_ROOT:
+        if (_rootCollection)
+          return beginCollection(*_rootCollection, _rootIsObject);
+        return writeScalar(_root);
+
+      case STEP_KEY: {
+        const char *key = top().slot->key();
+        beginText(TEXT_KEY, key, strlen(key));
+        return STEP_TEXT;
+      }
+
+      case STEP_VALUE:
+        return writeValue(*top().slot->data());
+
+      case STEP_TEXT:
+        return writeTextPart();
+
+      case STEP_TEXT_END:
+        return endText();
+
+      case STEP_NEXT:
+        return writeNext();
+
+      case STEP_END:
+        if (top().isObject)
+          _serializer.endObject();
+        else
+          _serializer.endArray();
+        if (_chunk.overflowed())
+          return STEP_END;
+        _depth--;
+        return STEP_NEXT;
+
+      default:
+        return STEP_DONE;
+    }
+  }
+
+  Step writeValue(const VariantData &value) {
+    if (value.isArray())
+      return beginCollection(*value.asArray(), false);
+    if (value.isObject())
+      return beginCollection(*value.asObject(), true);
+    return writeScalar(value);
+  }
+
+  Step writeScalar(const VariantData &value) {
+    _text.kind = TEXT_NONE;
+    ValueWriter writer(this);
+    value.accept(writer);
+    return _text.kind == TEXT_NONE ? STEP_NEXT : STEP_TEXT;
+  }
+
+  // Writes the header of the text, and prepares writeTextPart()
+  void beginText(TextKind kind, const char *data, size_t size) {
+    _text.kind = kind;
+    _text.data = data;
+    _text.size = size;
+    _text.offset = 0;
+    switch (kind) {
+      case TEXT_KEY:
+      case TEXT_STRING:
+        _serializer.beginString(size);
+        break;
+      case TEXT_BINARY:
+        _serializer.beginBinary(size);
+        break;
+      case TEXT_EXTENSION:
+        _serializer.beginExtension(size);
+        _text.size = size + 1;  // the type, then the data
+        break;
+      default:
+        break;
+    }
+  }
+
+  // Writes the next slice of the text.
+  // The slice fills the room left in the buffer, unless its escaped form is
+  // longer. In that case, the text resumes after the last character that was
+  // completely written, so that the next call doesn't scan this slice again.
+  Step writeTextPart() {
+    size_t remaining = _text.size - _text.offset;
+    if (remaining == 0)
+      return STEP_TEXT_END;
+    size_t room = _chunk.room();
+    if (room == 0)
+      room = 1;  // it overflows, but it writes the skipped bytes
+    size_t slice = remaining < room ? remaining : room;
+    const char *p = _text.data + _text.offset;
+    writeText(_serializer, p, slice);
+    if (_chunk.overflowed()) {
+      size_t partial;
+      _text.offset += measureText(p, slice, _chunk.tokenSize(), partial);
+      _chunk.restartToken(partial);
+      return STEP_TEXT;
+    }
+    _text.offset += slice;
+    return _text.offset < _text.size ? STEP_TEXT : STEP_TEXT_END;
+  }
+
+  template <typename TTarget>
+  void writeText(TTarget &target, const char *p, size_t n) const {
+    switch (_text.kind) {
+      case TEXT_KEY:
+      case TEXT_STRING:
+        target.writeStringPart(p, n);
+        break;
+      case TEXT_RAW:
+        target.writeRawPart(p, n);
+        break;
+      default:
+        target.writeBinaryPart(p, n);
+        break;
+    }
+  }
+
+  // Returns the number of characters whose output fits in `written` bytes,
+  // and the number of bytes of the next one in `partial`
+  size_t measureText(const char *p, size_t n, size_t written,
+                     size_t &partial) const {
+    DummyWriter dummy;
+    TSerializer<DummyWriter> measurer(dummy);
+    for (size_t i = 0; i < n; i++) {
+      size_t before = measurer.bytesWritten();
+      writeText(measurer, p + i, 1);
+      if (measurer.bytesWritten() > written) {
+        partial = written - before;
+        return i;
+      }
+    }
+    partial = 0;
+    return n;
+  }
+
+  Step endText() {
+    switch (_text.kind) {
+      case TEXT_KEY:
+        _serializer.endString();
+        _serializer.writeKeySeparator();
+        return STEP_VALUE;
+      case TEXT_STRING:
+        _serializer.endString();
+        return STEP_NEXT;
+      default:
+        return STEP_NEXT;
+    }
+  }
+
+  Step beginCollection(const CollectionData &collection, bool isObject) {
+    if (_depth >= maxDepth) {
+      _failed = true;
+      return STEP_DONE;
+    }
+    if (isObject)
+      _serializer.beginObject(collection);
+    else
+      _serializer.beginArray(collection);
+    if (_chunk.overflowed())
+      return _step;
+    Frame &frame = _stack[_depth++];
+    frame.slot = collection.head();
+    frame.isObject = isObject;
+    return firstStep(frame);
+  }
+
+  Step writeNext() {
+    if (_depth == 0)
+      return STEP_DONE;
+    Frame &frame = top();
+    const VariantSlot *next = frame.slot->next();
+    if (!next)
+      return STEP_END;
+    _serializer.writeSeparator();
+    if (_chunk.overflowed())
+      return STEP_NEXT;
+    frame.slot = next;
+    return firstStep(frame);
+  }
+
+  static Step firstStep(const Frame &frame) {
+    if (!frame.slot)
+      return STEP_END;
+    return frame.isObject ? STEP_KEY : STEP_VALUE;
+  }
+
+  Frame &top() {
+    return _stack[_depth - 1];
+  }
+
+  Chunk _chunk;
+  Writer<Chunk> _writer;
+  TSerializer<Writer<Chunk> > _serializer;
+  VariantData _root;
+  const CollectionData *_rootCollection;
+  bool _rootIsObject;
+  Frame _stack[maxDepth];
+  Text _text;
+  size_t _depth;
+  Step _step;
+  size_t _tokenOffset;
+  bool _failed;
+};
+
+}  // namespace ARDUINOJSON_NAMESPACE
@@ -28,6 +28,7 @@ class Writer {
 
 }  // namespace ARDUINOJSON_NAMESPACE
 
+#include <ArduinoJson/Serialization/Writers/SegmentWriter.hpp>
 #include <ArduinoJson/Serialization/Writers/StaticStringWriter.hpp>
 
 #if ARDUINOJSON_ENABLE_STD_STRING
@@ -37,6 +37,10 @@ class Writer< ::String, void> {
   }
 
  private:
+  // Non-copyable: a copy would duplicate the buffered characters
+  Writer(const Writer &);
+  Writer &operator=(const Writer &);
+
   void flush() {
     ARDUINOJSON_ASSERT(_size < bufferCapacity);
     _buffer[_size] = 0;
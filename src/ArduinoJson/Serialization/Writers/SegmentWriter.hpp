@@ -0,0 +1,132 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Namespace.hpp>
+
+#include <stddef.h>  // size_t
+#include <stdint.h>  // uint8_t
+#include <string.h>  // memcpy
+
+namespace ARDUINOJSON_NAMESPACE {
+
+// A piece of the output of SegmentWriter, like a struct iovec
+struct OutputSegment {
+  const char *data;
+  size_t size;
+};
+
+// A destination for serializeJson() and serializeMsgPack() that produces a
+// list of segments for writev() or sendmsg() instead of a contiguous copy.
+// The long strings and raw values are referenced where they are (in the
+// memory pool or in the user's memory); the rest is copied in the scratch
+// buffer.
+// When the scratch buffer or the segments run out, the output is truncated:
+// the following writes return 0 until clear(), so it never has holes.
+// CAUTION: the segments remain valid as long as the document and the scratch
+// buffer are unchanged.
+class SegmentWriter {
+ public:
+  // The serializers write numbers and other temporary data in blocks
+  // smaller than this, so that only stable memory is referenced.
+  static const size_t minZeroCopySize = 32;
+
+  SegmentWriter(OutputSegment *segments, size_t maxSegments, char *scratch,
+                size_t scratchSize)
+      : _segments(segments),
+        _maxSegments(maxSegments),
+        _count(0),
+        _scratch(scratch),
+        _scratchEnd(scratch + scratchSize),
+        _scratchPtr(scratch),
+        _overflowed(false) {}
+
+  size_t write(uint8_t c) {
+    return write(&c, 1);
+  }
+
+  size_t write(const uint8_t *s, size_t n) {
+    if (_overflowed)
+      return 0;
+    size_t written = n < minZeroCopySize ? copy(s, n) : reference(s, n);
+    if (written < n)
+      _overflowed = true;
+    return written;
+  }
+
+  // Number of segments
+  size_t size() const {
+    return _count;
+  }
+
+  const OutputSegment &operator[](size_t i) const {
+    return _segments[i];
+  }
+
+  // Tells if the output was truncated
+  bool overflowed() const {
+    return _overflowed;
+  }
+
+  // Forgets the segments to reuse the writer
+  void clear() {
+    _count = 0;
+    _scratchPtr = _scratch;
+    _overflowed = false;
+  }
+
+ private:
+  size_t reference(const uint8_t *s, size_t n) {
+    OutputSegment *segment = addSegment();
+    if (!segment)
+      return 0;
+    segment->data = reinterpret_cast<const char *>(s);
+    segment->size = n;
+    return n;
+  }
+
+  size_t copy(const uint8_t *s, size_t n) {
+    size_t room = size_t(_scratchEnd - _scratchPtr);
+    if (n > room)
+      n = room;
+    if (n == 0)
+      return 0;
+
+    // extend the last segment if it ends where the scratch buffer continues
+    OutputSegment *segment = lastSegment();
+    if (!segment || segment->data + segment->size != _scratchPtr) {
+      segment = addSegment();
+      if (!segment)
+        return 0;
+      segment->data = _scratchPtr;
+      segment->size = 0;
+    }
+
+    memcpy(_scratchPtr, s, n);
+    _scratchPtr += n;
+    segment->size += n;
+    return n;
+  }
+
+  OutputSegment *lastSegment() {
+    return _count ? &_segments[_count - 1] : 0;
+  }
+
+  OutputSegment *addSegment() {
+    if (_count >= _maxSegments)
+      return 0;
+    return &_segments[_count++];
+  }
+
+  OutputSegment *_segments;
+  size_t _maxSegments;
+  size_t _count;
+  char *_scratch;
+  char *_scratchEnd;
+  char *_scratchPtr;
+  bool _overflowed;
+};
+
+}  // namespace ARDUINOJSON_NAMESPACE
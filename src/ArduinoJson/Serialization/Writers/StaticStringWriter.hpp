@@ -6,31 +6,35 @@
 
 #include <ArduinoJson/Namespace.hpp>
 
+#include <string.h>  // memcpy
+
 namespace ARDUINOJSON_NAMESPACE {
 
 // A Print implementation that allows to write in a char[]
+// It keeps room for the terminator, but doesn't write it after each char:
+// serialize() adds it at the end.
 class StaticStringWriter {
  public:
   StaticStringWriter(char *buf, size_t size) : end(buf + size - 1), p(buf) {
-    *p = '\0';
+    if (size)
+      *p = '\0';
   }
 
   size_t write(uint8_t c) {
     if (p >= end)
       return 0;
     *p++ = static_cast<char>(c);
-    *p = '\0';
     return 1;
   }
 
   size_t write(const uint8_t *s, size_t n) {
-    char *begin = p;
-    while (p < end && n > 0) {
-      *p++ = static_cast<char>(*s++);
-      n--;
-    }
-    *p = '\0';
-    return size_t(p - begin);
+    // with an empty buffer, end is before p
+    size_t room = p < end ? size_t(end - p) : 0;
+    if (n > room)
+      n = room;
+    memcpy(p, s, n);
+    p += n;
+    return n;
   }
 
  private:
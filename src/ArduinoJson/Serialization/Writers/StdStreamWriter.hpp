@@ -4,29 +4,61 @@
 
 #pragma once
 
+#include <string.h>  // memcpy
 #include <ostream>
 
 namespace ARDUINOJSON_NAMESPACE {
 
+// Accumulates the characters in a buffer and writes them to the stream in
+// blocks, because ostream::put() is expensive.
 template <typename TDestination>
 class Writer<
     TDestination,
     typename enable_if<is_base_of<std::ostream, TDestination>::value>::type> {
+  static const size_t bufferCapacity = ARDUINOJSON_STRING_BUFFER_SIZE;
+
  public:
-  explicit Writer(std::ostream& os) : _os(&os) {}
+  explicit Writer(std::ostream& os) : _os(&os), _size(0) {}
+
+  ~Writer() {
+    flush();
+  }
 
   size_t write(uint8_t c) {
-    _os->put(static_cast<char>(c));
+    _buffer[_size++] = static_cast<char>(c);
+    if (_size == bufferCapacity)
+      flush();
     return 1;
   }
 
   size_t write(const uint8_t* s, size_t n) {
-    _os->write(reinterpret_cast<const char*>(s),
-               static_cast<std::streamsize>(n));
+    if (_size + n <= bufferCapacity) {
+      memcpy(_buffer + _size, s, n);
+      _size += n;
+      if (_size == bufferCapacity)
+        flush();
+    } else {
+      flush();
+      _os->write(reinterpret_cast<const char*>(s),
+                 static_cast<std::streamsize>(n));
+    }
     return n;
   }
 
  private:
+  // Non-copyable: a copy would duplicate the buffered characters
+  Writer(const Writer&);
+  Writer& operator=(const Writer&);
+
+  void flush() {
+    if (_size == 0)
+      return;
+    _os->write(_buffer, static_cast<std::streamsize>(_size));
+    _size = 0;
+  }
+
   std::ostream* _os;
+  char _buffer[bufferCapacity];
+  size_t _size;
 };
 }  // namespace ARDUINOJSON_NAMESPACE
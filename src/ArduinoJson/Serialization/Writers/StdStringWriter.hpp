@@ -7,6 +7,7 @@
 #include <ArduinoJson/Namespace.hpp>
 #include <ArduinoJson/Polyfills/type_traits.hpp>
 
+#include <string.h>  // memcpy
 #include <string>
 
 namespace ARDUINOJSON_NAMESPACE {
@@ -18,23 +19,54 @@ template <class TCharTraits, class TAllocator>
 struct is_std_string<std::basic_string<char, TCharTraits, TAllocator> >
     : true_type {};
 
+// Accumulates the characters in a buffer and appends them to the string in
+// blocks, because the serializers write one character at a time.
 template <typename TDestination>
 class Writer<TDestination,
              typename enable_if<is_std_string<TDestination>::value>::type> {
+  static const size_t bufferCapacity = ARDUINOJSON_STRING_BUFFER_SIZE;
+
  public:
-  Writer(TDestination &str) : _str(&str) {}
+  Writer(TDestination &str) : _str(&str), _size(0) {}
+
+  ~Writer() {
+    flush();
+  }
 
   size_t write(uint8_t c) {
-    _str->operator+=(static_cast<char>(c));
+    _buffer[_size++] = static_cast<char>(c);
+    if (_size == bufferCapacity)
+      flush();
     return 1;
   }
 
   size_t write(const uint8_t *s, size_t n) {
-    _str->append(reinterpret_cast<const char *>(s), n);
+    if (_size + n <= bufferCapacity) {
+      memcpy(_buffer + _size, s, n);
+      _size += n;
+      if (_size == bufferCapacity)
+        flush();
+    } else {
+      flush();
+      _str->append(reinterpret_cast<const char *>(s), n);
+    }
     return n;
   }
 
  private:
+  // Non-copyable: a copy would duplicate the buffered characters
+  Writer(const Writer &);
+  Writer &operator=(const Writer &);
+
+  void flush() {
+    if (_size == 0)
+      return;
+    _str->append(_buffer, _size);
+    _size = 0;
+  }
+
   TDestination *_str;
+  char _buffer[bufferCapacity];
+  size_t _size;
 };
 }  // namespace ARDUINOJSON_NAMESPACE
@@ -10,7 +10,7 @@ namespace ARDUINOJSON_NAMESPACE {
 
 template <template <typename> class TSerializer, typename TSource,
           typename TWriter>
-size_t doSerialize(const TSource &source, TWriter writer) {
+size_t doSerialize(const TSource &source, TWriter &writer) {
   TSerializer<TWriter> serializer(writer);
   source.accept(serializer);
   return serializer.bytesWritten();
@@ -25,8 +25,12 @@ size_t serialize(const TSource &source, TDestination &destination) {
 
 template <template <typename> class TSerializer, typename TSource>
 size_t serialize(const TSource &source, void *buffer, size_t bufferSize) {
-  StaticStringWriter writer(reinterpret_cast<char *>(buffer), bufferSize);
-  return doSerialize<TSerializer>(source, writer);
+  char *s = reinterpret_cast<char *>(buffer);
+  StaticStringWriter writer(s, bufferSize);
+  size_t n = doSerialize<TSerializer>(source, writer);
+  if (bufferSize)
+    s[n] = '\0';
+  return n;
 }
 
 template <template <typename> class TSerializer, typename TSource,
@@ -37,8 +41,7 @@ typename enable_if<sizeof(remove_reference<TChar>::type) == 1, size_t>::type
 typename enable_if<sizeof(TChar) == 1, size_t>::type
 #endif
 serialize(const TSource &source, TChar (&buffer)[N]) {
-  StaticStringWriter writer(reinterpret_cast<char *>(buffer), N);
-  return doSerialize<TSerializer>(source, writer);
+  return serialize<TSerializer>(source, buffer, N);
 }
 
 }  // namespace ARDUINOJSON_NAMESPACE
@@ -19,6 +19,16 @@ class StringCopier {
     return StringBuilder(_pool);
   }
 
+  // Allocates a string of n characters, plus the terminator, when the size is
+  // known in advance.
+  // n comes from the input, so it's checked before adding the terminator,
+  // which would wrap around to 0 with n == SIZE_MAX.
+  char* allocString(size_t n) {
+    if (n >= _pool->capacity() - _pool->size())
+      return 0;
+    return _pool->allocFrozenString(n + 1);
+  }
+
   void reclaim(const char* s) {
     _pool->reclaimLastString(s);
   }
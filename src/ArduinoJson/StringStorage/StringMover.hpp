@@ -34,6 +34,15 @@ class StringMover {
     return StringBuilder(&_ptr);
   }
 
+  // Reserves a string of n characters, plus the terminator, in the input.
+  // The caller must read the n characters before writing the terminator,
+  // because the terminator overwrites the byte that follows them.
+  char* allocString(size_t n) {
+    char* s = _ptr;
+    _ptr += n + 1;
+    return s;
+  }
+
   // recover memory from last string
   void reclaim(const char* str) {
     _ptr = const_cast<char*>(str);
@@ -45,6 +45,10 @@ class ArduinoStringAdapter {
     return _str->length();
   }
 
+  char operator[](size_t i) const {
+    return _str->c_str()[i];
+  }
+
   typedef storage_policy::store_by_copy storage_policy;
 
  private:
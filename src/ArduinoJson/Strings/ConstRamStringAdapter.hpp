@@ -7,6 +7,7 @@
 #include <stddef.h>  // size_t
 #include <string.h>  // strcmp
 
+#include <ArduinoJson/Polyfills/assert.hpp>
 #include <ArduinoJson/Polyfills/safe_strcmp.hpp>
 #include <ArduinoJson/Strings/IsString.hpp>
 #include <ArduinoJson/Strings/StoragePolicy.hpp>
@@ -35,6 +36,11 @@ class ConstRamStringAdapter {
     return strlen(_str);
   }
 
+  char operator[](size_t i) const {
+    ARDUINOJSON_ASSERT(_str != 0);
+    return _str[i];
+  }
+
   const char* data() const {
     return _str;
   }
@@ -46,6 +46,10 @@ class StlStringAdapter {
     return _str->size();
   }
 
+  char operator[](size_t i) const {
+    return (*_str)[i];
+  }
+
   typedef storage_policy::store_by_copy storage_policy;
 
  private:
@@ -0,0 +1,47 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2020
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Namespace.hpp>
+
+#include <stddef.h>  // size_t
+#include <stdint.h>  // uint32_t
+
+namespace ARDUINOJSON_NAMESPACE {
+
+// FNV-1a
+class StringHasher {
+ public:
+  StringHasher() : _hash(2166136261u) {}
+
+  void append(char c) {
+    _hash ^= static_cast<unsigned char>(c);
+    _hash *= 16777619u;
+  }
+
+  size_t value() const {
+    return static_cast<size_t>(_hash);
+  }
+
+ private:
+  uint32_t _hash;
+};
+
+inline size_t hashString(const char* s) {
+  StringHasher hasher;
+  while (*s) hasher.append(*s++);
+  return hasher.value();
+}
+
+// CAUTION: the adapted string must not be null
+template <typename TAdaptedString>
+inline size_t hashAdaptedString(const TAdaptedString& s) {
+  StringHasher hasher;
+  size_t n = s.size();
+  for (size_t i = 0; i < n; i++) hasher.append(s[i]);
+  return hasher.value();
+}
+
+}  // namespace ARDUINOJSON_NAMESPACE
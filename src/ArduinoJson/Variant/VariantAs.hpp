@@ -85,6 +85,18 @@ variantAs(const VariantData* data) {
   return data != 0 ? data->asString() : 0;
 }
 
+template <typename T>
+inline typename enable_if<is_same<T, MsgPackBinary>::value, T>::type variantAs(
+    const VariantData* data) {
+  return data != 0 ? data->asBinary() : MsgPackBinary();
+}
+
+template <typename T>
+inline typename enable_if<is_same<T, MsgPackExtension>::value, T>::type
+variantAs(const VariantData* data) {
+  return data != 0 ? data->asExtension() : MsgPackExtension();
+}
+
 template <typename T>
 T variantAs(VariantData* data, MemoryPool*) {
   // By default use the read-only conversion.
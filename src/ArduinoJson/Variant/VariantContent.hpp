@@ -28,6 +28,13 @@ enum {
   VALUE_IS_POSITIVE_INTEGER = 0x08,
   VALUE_IS_NEGATIVE_INTEGER = 0x0A,
   VALUE_IS_FLOAT = 0x0C,
+  VALUE_IS_INLINE_STRING = 0x0E,  // see ARDUINOJSON_ENABLE_INLINE_STRINGS
+
+  // MessagePack bin and ext, always stored in the pool (or in the input)
+  // asRaw.data points to the bytes, followed by a terminator for the binary,
+  // and preceded by the type for the extension.
+  VALUE_IS_OWNED_BINARY = 0x11,
+  VALUE_IS_OWNED_EXTENSION = 0x13,
 
   COLLECTION_MASK = 0x60,
   VALUE_IS_OBJECT = 0x20,
@@ -4,12 +4,16 @@
 
 #pragma once
 
+#include <ArduinoJson/Memory/PoolRelocation.hpp>
 #include <ArduinoJson/Misc/SerializedValue.hpp>
+#include <ArduinoJson/MsgPack/MsgPackBinary.hpp>
 #include <ArduinoJson/Numbers/convertNumber.hpp>
 #include <ArduinoJson/Polyfills/gsl/not_null.hpp>
 #include <ArduinoJson/Strings/RamStringAdapter.hpp>
 #include <ArduinoJson/Variant/VariantContent.hpp>
 
+#include <string.h>  // memchr
+
 // VariantData can't have a constructor (to be a POD), so we have no way to fix
 // this warning
 #if defined(__GNUC__)
@@ -49,10 +53,19 @@ class VariantData {
       case VALUE_IS_OWNED_STRING:
         return visitor.visitString(_content.asString);
 
+      case VALUE_IS_INLINE_STRING:
+        return visitor.visitString(asString());
+
       case VALUE_IS_OWNED_RAW:
       case VALUE_IS_LINKED_RAW:
         return visitor.visitRawJson(_content.asRaw.data, _content.asRaw.size);
 
+      case VALUE_IS_OWNED_BINARY:
+        return visitor.visitBinary(_content.asRaw.data, _content.asRaw.size);
+
+      case VALUE_IS_OWNED_EXTENSION:
+        return visitor.visitExtension(_content.asRaw.data, _content.asRaw.size);
+
       case VALUE_IS_NEGATIVE_INTEGER:
         return visitor.visitNegativeInteger(_content.asInteger);
 
@@ -75,6 +88,19 @@ class VariantData {
 
   const char *asString() const;
 
+  MsgPackBinary asBinary() const {
+    if (type() != VALUE_IS_OWNED_BINARY)
+      return MsgPackBinary();
+    return MsgPackBinary(_content.asRaw.data, _content.asRaw.size);
+  }
+
+  MsgPackExtension asExtension() const {
+    if (type() != VALUE_IS_OWNED_EXTENSION)
+      return MsgPackExtension();
+    return MsgPackExtension(static_cast<int8_t>(_content.asRaw.data[0]),
+                            _content.asRaw.data + 1, _content.asRaw.size);
+  }
+
   bool asBoolean() const;
 
   CollectionData *asArray() {
@@ -104,6 +130,10 @@ class VariantData {
       case VALUE_IS_OWNED_RAW:
         return setOwnedRaw(
             serialized(src._content.asRaw.data, src._content.asRaw.size), pool);
+      case VALUE_IS_OWNED_BINARY:
+        return setBinary(src.asBinary(), pool);
+      case VALUE_IS_OWNED_EXTENSION:
+        return setExtension(src.asExtension(), pool);
       default:
         setType(src.type());
         _content = src._content;
@@ -112,21 +142,31 @@ class VariantData {
   }
 
   bool equals(const VariantData &other) const {
-    // Check that variant have the same type, but ignore string ownership
+    // Ignore how the strings are stored
+    if (isString() && other.isString())
+      return !strcmp(asString(), other.asString());
+
+    // Check that variant have the same type, but ignore raw ownership
     if ((type() | VALUE_IS_OWNED) != (other.type() | VALUE_IS_OWNED))
       return false;
 
     switch (type()) {
-      case VALUE_IS_LINKED_STRING:
-      case VALUE_IS_OWNED_STRING:
-        return !strcmp(_content.asString, other._content.asString);
-
       case VALUE_IS_LINKED_RAW:
       case VALUE_IS_OWNED_RAW:
         return _content.asRaw.size == other._content.asRaw.size &&
                !memcmp(_content.asRaw.data, other._content.asRaw.data,
                        _content.asRaw.size);
 
+      case VALUE_IS_OWNED_BINARY:
+        return _content.asRaw.size == other._content.asRaw.size &&
+               !memcmp(_content.asRaw.data, other._content.asRaw.data,
+                       _content.asRaw.size);
+
+      case VALUE_IS_OWNED_EXTENSION:  // compare the type too
+        return _content.asRaw.size == other._content.asRaw.size &&
+               !memcmp(_content.asRaw.data, other._content.asRaw.data,
+                       _content.asRaw.size + 1);
+
       case VALUE_IS_BOOLEAN:
       case VALUE_IS_POSITIVE_INTEGER:
       case VALUE_IS_NEGATIVE_INTEGER:
@@ -151,6 +191,10 @@ class VariantData {
     return (_flags & VALUE_IS_ARRAY) != 0;
   }
 
+  bool isBinary() const {
+    return type() == VALUE_IS_OWNED_BINARY;
+  }
+
   bool isBoolean() const {
     return type() == VALUE_IS_BOOLEAN;
   }
@@ -173,13 +217,18 @@ class VariantData {
     }
   }
 
+  bool isExtension() const {
+    return type() == VALUE_IS_OWNED_EXTENSION;
+  }
+
   bool isFloat() const {
     return type() == VALUE_IS_FLOAT || type() == VALUE_IS_POSITIVE_INTEGER ||
            type() == VALUE_IS_NEGATIVE_INTEGER;
   }
 
   bool isString() const {
-    return type() == VALUE_IS_LINKED_STRING || type() == VALUE_IS_OWNED_STRING;
+    return type() == VALUE_IS_LINKED_STRING ||
+           type() == VALUE_IS_OWNED_STRING || type() == VALUE_IS_INLINE_STRING;
   }
 
   bool isObject() const {
@@ -239,6 +288,46 @@ class VariantData {
     }
   }
 
+  // Takes size bytes, followed by a terminator, that are already in the pool
+  void setOwnedBinary(const char *data, size_t size) {
+    setType(VALUE_IS_OWNED_BINARY);
+    _content.asRaw.data = data;
+    _content.asRaw.size = size;
+  }
+
+  bool setBinary(MsgPackBinary value, MemoryPool *pool) {
+    char *dup = value.isNull() ? 0 : pool->allocFrozenString(value.size() + 1);
+    if (dup) {
+      memcpy(dup, value.data(), value.size());
+      dup[value.size()] = 0;
+      setOwnedBinary(dup, value.size());
+      return true;
+    } else {
+      setType(VALUE_IS_NULL);
+      return false;
+    }
+  }
+
+  // Takes the type, followed by size bytes, that are already in the pool
+  void setOwnedExtension(const char *data, size_t size) {
+    setType(VALUE_IS_OWNED_EXTENSION);
+    _content.asRaw.data = data;
+    _content.asRaw.size = size;
+  }
+
+  bool setExtension(MsgPackExtension value, MemoryPool *pool) {
+    char *dup = value.isNull() ? 0 : pool->allocFrozenString(value.size() + 1);
+    if (dup) {
+      dup[0] = static_cast<char>(value.type());
+      memcpy(dup + 1, value.data(), value.size());
+      setOwnedExtension(dup, value.size());
+      return true;
+    } else {
+      setType(VALUE_IS_NULL);
+      return false;
+    }
+  }
+
   template <typename T>
   typename enable_if<is_unsigned<T>::value>::type setInteger(T value) {
     setUnsignedInteger(value);
@@ -303,9 +392,35 @@ class VariantData {
 
   template <typename T>
   bool setOwnedString(T value, MemoryPool *pool) {
+#if ARDUINOJSON_ENABLE_INLINE_STRINGS
+    if (!value.isNull() && value.size() < sizeof(VariantContent)) {
+      char *dst = reinterpret_cast<char *>(&_content);
+      size_t n = value.size();
+      for (size_t i = 0; i < n; i++) dst[i] = value[i];
+      dst[n] = 0;
+      setType(VALUE_IS_INLINE_STRING);
+      return true;
+    }
+#endif
     return setOwnedString(value.save(pool));
   }
 
+  // Copies a short string inside the variant.
+  // Returns false if the string doesn't fit, or if the feature is disabled.
+  bool setInlineString(const char *s) {
+#if ARDUINOJSON_ENABLE_INLINE_STRINGS
+    size_t n = strlen(s);
+    if (n < sizeof(VariantContent)) {
+      memcpy(&_content, s, n + 1);
+      setType(VALUE_IS_INLINE_STRING);
+      return true;
+    }
+#else
+    (void)s;
+#endif
+    return false;
+  }
+
   CollectionData &toArray() {
     setType(VALUE_IS_ARRAY);
     _content.asCollection.clear();
@@ -324,6 +439,9 @@ class VariantData {
         return strlen(_content.asString) + 1;
       case VALUE_IS_OWNED_RAW:
         return _content.asRaw.size;
+      case VALUE_IS_OWNED_BINARY:
+      case VALUE_IS_OWNED_EXTENSION:
+        return _content.asRaw.size + 1;
       case VALUE_IS_OBJECT:
       case VALUE_IS_ARRAY:
         return _content.asCollection.memoryUsage();
@@ -374,11 +492,44 @@ class VariantData {
     return _content.asCollection.getOrAddMember(key, pool);
   }
 
-  void movePointers(ptrdiff_t stringDistance, ptrdiff_t variantDistance) {
+  void movePointers(PoolRelocation &relocation) {
     if (_flags & VALUE_IS_OWNED)
-      _content.asString += stringDistance;
+      relocation.moveString(_content.asString);
+    else if (type() == VALUE_IS_LINKED_STRING || type() == VALUE_IS_LINKED_RAW)
+      relocation.linkedStrings = true;
     if (_flags & COLLECTION_MASK)
-      _content.asCollection.movePointers(stringDistance, variantDistance);
+      _content.asCollection.movePointers(relocation);
+  }
+
+  // Tells if movePointers() would succeed, without changing anything, and
+  // if the pointers remain in the pool (see PoolRelocation)
+  bool canMovePointers(PoolRelocation &relocation) const {
+    switch (type()) {
+      case VALUE_IS_OWNED_STRING:
+        return relocation.isValidString(_content.asString);
+
+      case VALUE_IS_OWNED_RAW:
+      case VALUE_IS_OWNED_BINARY:
+        return relocation.isValidBytes(_content.asRaw.data,
+                                       _content.asRaw.size);
+
+      case VALUE_IS_OWNED_EXTENSION:  // preceded by the type
+        return relocation.isValidBytes(_content.asRaw.data,
+                                       _content.asRaw.size, 1);
+
+      case VALUE_IS_INLINE_STRING:
+        return memchr(&_content, 0, sizeof(_content)) != 0;
+
+      case VALUE_IS_ARRAY:
+      case VALUE_IS_OBJECT:
+        return _content.asCollection.canMovePointers(relocation);
+
+      default:
+        // linked strings never move, and the other types have no pointer
+        return (type() & (VALUE_IS_OWNED | COLLECTION_MASK)) == 0 &&
+               type() != VALUE_IS_LINKED_STRING &&
+               type() != VALUE_IS_LINKED_RAW;
+    }
   }
 
  private:
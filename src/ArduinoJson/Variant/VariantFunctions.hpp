@@ -52,10 +52,18 @@ inline bool variantIsArray(const VariantData *var) {
   return var && var->isArray();
 }
 
+inline bool variantIsBinary(const VariantData *var) {
+  return var && var->isBinary();
+}
+
 inline bool variantIsBoolean(const VariantData *var) {
   return var && var->isBoolean();
 }
 
+inline bool variantIsExtension(const VariantData *var) {
+  return var && var->isExtension();
+}
+
 template <typename T>
 inline bool variantIsInteger(const VariantData *var) {
   return var && var->isInteger<T>();
@@ -105,6 +113,16 @@ inline bool variantSetOwnedRaw(VariantData *var, SerializedValue<T> value,
   return var != 0 && var->setOwnedRaw(value, pool);
 }
 
+inline bool variantSetBinary(VariantData *var, MsgPackBinary value,
+                             MemoryPool *pool) {
+  return var != 0 && var->setBinary(value, pool);
+}
+
+inline bool variantSetExtension(VariantData *var, MsgPackExtension value,
+                                MemoryPool *pool) {
+  return var != 0 && var->setExtension(value, pool);
+}
+
 inline bool variantSetLinkedString(VariantData *var, const char *value) {
   if (!var)
     return false;
@@ -24,7 +24,8 @@ inline T VariantData::asIntegral() const {
       return convertNegativeInteger<T>(_content.asInteger);
     case VALUE_IS_LINKED_STRING:
     case VALUE_IS_OWNED_STRING:
-      return parseInteger<T>(_content.asString);
+    case VALUE_IS_INLINE_STRING:
+      return parseInteger<T>(asString());
     case VALUE_IS_FLOAT:
       return convertFloat<T>(_content.asFloat);
     default:
@@ -58,7 +59,8 @@ inline T VariantData::asFloat() const {
       return -static_cast<T>(_content.asInteger);
     case VALUE_IS_LINKED_STRING:
     case VALUE_IS_OWNED_STRING:
-      return parseFloat<T>(_content.asString);
+    case VALUE_IS_INLINE_STRING:
+      return parseFloat<T>(asString());
     case VALUE_IS_FLOAT:
       return static_cast<T>(_content.asFloat);
     default:
@@ -71,6 +73,8 @@ inline const char *VariantData::asString() const {
     case VALUE_IS_LINKED_STRING:
     case VALUE_IS_OWNED_STRING:
       return _content.asString;
+    case VALUE_IS_INLINE_STRING:
+      return reinterpret_cast<const char *>(&_content);
     default:
       return 0;
   }
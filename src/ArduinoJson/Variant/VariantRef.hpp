@@ -74,6 +74,21 @@ class VariantRefBase {
     return variantIsString(_data);
   }
   //
+  // bool is<MsgPackBinary>() const;
+  template <typename T>
+  FORCE_INLINE typename enable_if<is_same<T, MsgPackBinary>::value, bool>::type
+  is() const {
+    return variantIsBinary(_data);
+  }
+  //
+  // bool is<MsgPackExtension>() const;
+  template <typename T>
+  FORCE_INLINE
+      typename enable_if<is_same<T, MsgPackExtension>::value, bool>::type
+      is() const {
+    return variantIsExtension(_data);
+  }
+  //
   // bool is<ArrayRef> const;
   // bool is<const ArrayRef> const;
   template <typename T>
@@ -202,6 +217,16 @@ class VariantRef : public VariantRefBase<VariantData>,
     return variantSetOwnedRaw(_data, value, _pool);
   }
 
+  // set(MsgPackBinary), copies the bytes
+  FORCE_INLINE bool set(MsgPackBinary value) const {
+    return variantSetBinary(_data, value, _pool);
+  }
+
+  // set(MsgPackExtension), copies the bytes
+  FORCE_INLINE bool set(MsgPackExtension value) const {
+    return variantSetExtension(_data, value, _pool);
+  }
+
   // set(const std::string&)
   // set(const String&)
   template <typename T>
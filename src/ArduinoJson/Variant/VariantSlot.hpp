@@ -4,20 +4,36 @@
 
 #pragma once
 
+#include <ArduinoJson/Memory/PoolRelocation.hpp>
 #include <ArduinoJson/Polyfills/gsl/not_null.hpp>
 #include <ArduinoJson/Polyfills/type_traits.hpp>
 #include <ArduinoJson/Variant/VariantContent.hpp>
 
-#include <stdint.h>  // int8_t, int16_t
+#include <stddef.h>  // ptrdiff_t
+#include <stdint.h>  // int8_t, int16_t, int32_t, uintptr_t
 
 namespace ARDUINOJSON_NAMESPACE {
 
-typedef conditional<sizeof(void*) <= 2, int8_t, int16_t>::type VariantSlotDiff;
+#if ARDUINOJSON_SLOT_OFFSET_SIZE == 1
+typedef int8_t VariantSlotDiff;
+#elif ARDUINOJSON_SLOT_OFFSET_SIZE == 2
+typedef int16_t VariantSlotDiff;
+#elif ARDUINOJSON_SLOT_OFFSET_SIZE == 4
+typedef int32_t VariantSlotDiff;
+#else
+typedef conditional<sizeof(void*) <= 2, int8_t,
+                    conditional<sizeof(void*) <= 4, int16_t, int32_t>::type>::
+    type VariantSlotDiff;
+#endif
 
 class VariantSlot {
   // CAUTION: same layout as VariantData
   // we cannot use composition because it adds padding
   // (+20% on ESP8266 for example)
+  //
+  // The key and the strings are plain pointers, not offsets in the pool:
+  // linked strings and strings in a zero-copy input live outside the pool,
+  // and VariantConstRef doesn't know the pool, so it couldn't resolve them.
   VariantContent _content;
   uint8_t _flags;
   VariantSlotDiff _next;
@@ -64,11 +80,26 @@ class VariantSlot {
     _next = VariantSlotDiff(slot ? slot - this : 0);
   }
 
+  // Tells if the distance to this slot fits in a VariantSlotDiff
+  bool canLinkTo(const VariantSlot* slot) const {
+    if (!slot)
+      return true;
+    ptrdiff_t diff = slot - this;
+    return VariantSlotDiff(diff) == diff;
+  }
+
   void setNextNotNull(VariantSlot* slot) {
     ARDUINOJSON_ASSERT(slot != 0);
     _next = VariantSlotDiff(slot - this);
   }
 
+  // Copies the key and the value, but not the link to the next slot
+  void copyValueFrom(const VariantSlot& src) {
+    _content = src._content;
+    _flags = src._flags;
+    _key = src._key;
+  }
+
   void setOwnedKey(not_null<const char*> k) {
     _flags |= KEY_IS_OWNED;
     _key = k.get();
@@ -87,19 +118,40 @@ class VariantSlot {
     return (_flags & KEY_IS_OWNED) != 0;
   }
 
+  bool isLinkedString() const {
+    uint8_t t = _flags & VALUE_MASK;
+    return t == VALUE_IS_LINKED_STRING || t == VALUE_IS_LINKED_RAW;
+  }
+
   void clear() {
     _next = 0;
     _flags = 0;
     _key = 0;
   }
 
-  void movePointers(ptrdiff_t stringDistance, ptrdiff_t variantDistance) {
+  void movePointers(PoolRelocation& relocation) {
     if (_flags & KEY_IS_OWNED)
-      _key += stringDistance;
+      relocation.moveString(_key);
+    else if (_key)
+      relocation.linkedStrings = true;
     if (_flags & VALUE_IS_OWNED)
-      _content.asString += stringDistance;
+      relocation.moveString(_content.asString);
+    else if (isLinkedString())
+      relocation.linkedStrings = true;
     if (_flags & COLLECTION_MASK)
-      _content.asCollection.movePointers(stringDistance, variantDistance);
+      _content.asCollection.movePointers(relocation);
+  }
+
+  // See VariantData::canMovePointers()
+  bool canMovePointers(PoolRelocation& relocation) const;
+
+  // Returns the address of the next slot, or 0, without dereferencing it
+  uintptr_t nextAddress() const {
+    if (!_next)
+      return 0;
+    return reinterpret_cast<uintptr_t>(this) +
+           static_cast<uintptr_t>(ptrdiff_t(_next) *
+                                  ptrdiff_t(sizeof(VariantSlot)));
   }
 };
 